@@ -0,0 +1,204 @@
+/*
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Microbenchmark of the reservation table alone, without the simulator around it.
+ *
+ * A table of many identical nodes receives a stream of jobs. Every job is placed at the first time it fits, looking
+ * from its arrival with findPossibleAllocation and taking the first nodes that hold it, as FCFS does. The jobs that
+ * have finished by the next arrival are deallocated before it, so the table keeps a window of running and future
+ * reservations. The time spent looking for allocations, allocating and deallocating is reported separately, along
+ * with the mean wait of the jobs, which has to be the same for two versions of the table that schedule alike.
+ *
+ * Usage: reservationtable_bench [nodes] [jobs] [cpus per node] [seed]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+#include <deque>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <utils/log.h>
+#include <archdatamodel/node.h>
+#include <archdatamodel/compute.h>
+#include <scheduling/job.h>
+#include <scheduling/resourcebucket.h>
+#include <scheduling/resourcejoballocation.h>
+#include <scheduling/resourcereservationtable.h>
+
+using namespace std;
+using namespace Simulator;
+
+typedef chrono::steady_clock benchclock;
+
+/**
+ * Keeps the total time and number of calls of one kind of operation
+ */
+struct OperationTime {
+    double seconds; /**< The total time of the calls */
+    uint64_t calls; /**< The number of calls */
+
+    OperationTime() : seconds(0), calls(0) {
+    }
+
+    void add(benchclock::time_point start) {
+        this->seconds += chrono::duration<double>(benchclock::now() - start).count();
+        this->calls++;
+    }
+
+    void print(const string& name) const {
+        cout << "  " << setw(12) << left << name << right << setw(10) << this->calls << " calls " << fixed << setprecision(3)
+                << setw(10) << this->seconds << " s " << setw(10) << (this->calls ? this->seconds * 1e6 / this->calls : 0) << " us/call" << endl;
+    }
+};
+
+/**
+ * Takes from the candidates of a possible allocation the first nodes that hold the cpus of the job, as the FCFS
+ * policy does with the first fit resource selection
+ * @param job The job
+ * @param possible The possible allocation returned by findPossibleAllocation, it is deleted
+ * @return The allocation to pass to allocateJob
+ */
+ResourceJobAllocation* selectFirstFit(Job* job, ResourceJobAllocation* possible) {
+    const vector<AvailabilityWindow>& candidates = possible->getCandidates();
+    ResourceJobAllocation* allocation = new ResourceJobAllocation();
+    allocation->setStartTime(possible->getStartTime());
+    allocation->setEndTime(possible->getEndTime());
+
+    deque<ResourceBucket*> buckets;
+    uint32_t needed = job->getNumberProcessors();
+    for (uint32_t i = 0; i < candidates.size() and needed > 0; i++) {
+        uint32_t cpus = (needed > candidates[i].freeCPUs) ? candidates[i].freeCPUs : needed;
+        if (cpus == 0)
+            continue;
+        ReservationList rl = {0};
+        rl.cpus = cpus;
+        ResourceBucket* bucket = new ResourceBucket(rl, candidates[i].startTime, candidates[i].endTime);
+        bucket->setID(candidates[i].id);
+        buckets.push_back(bucket);
+        needed -= cpus;
+    }
+    allocation->setAllocations(buckets);
+    delete possible;
+    return allocation;
+}
+
+int main(int argc, char** argv) {
+    uint32_t numberOfNodes = (argc > 1) ? atoi(argv[1]) : 5000;
+    uint32_t numberOfJobs = (argc > 2) ? atoi(argv[2]) : 2000;
+    uint32_t cpusPerNode = (argc > 3) ? atoi(argv[3]) : 48;
+    uint32_t seed = (argc > 4) ? atoi(argv[4]) : 1;
+
+    uint64_t globalTime = 0;
+    Utils::Log* log = new Utils::Log("", "", 0, 0, false, &globalTime, true);
+
+    vector<ArchDataModel::Node*> nodes;
+    ResourceReservationTable* table = new ResourceReservationTable(log, 0);
+    for (uint32_t i = 0; i < numberOfNodes; i++) {
+        ArchDataModel::Node* node = new ArchDataModel::Node(i);
+        node->addResource(new ArchDataModel::Compute("bench", 2, cpusPerNode / 2, 0, 0, 0, 1, 0, 0, 0, node));
+        nodes.push_back(node);
+        table->addNode(node);
+    }
+
+    /*
+     * Most of the jobs are small and a few take a good part of the system. The jobs arrive faster than the system
+     * can serve them, so after the first ones they wait and the table holds reservations in the future.
+     */
+    mt19937_64 random(seed);
+    geometric_distribution<uint32_t> sizeDistribution(0.005);
+    uniform_real_distribution<double> runtimeDistribution(60, 4 * 3600);
+    double meanCPUs = 1 / 0.005;
+    double meanRuntime = (60 + 4 * 3600) / 2.0;
+    exponential_distribution<double> arrivalDistribution(1.25 * numberOfNodes * cpusPerNode / (meanCPUs * meanRuntime));
+
+    typedef pair<double, Job*> Finish;
+    priority_queue<Finish, vector<Finish>, greater<Finish> > running;
+    vector<Job*> jobs;
+    OperationTime lookup, allocate, deallocate;
+    uint64_t searches = 0;
+    double sumOfWaits = 0;
+    double now = 0;
+
+    benchclock::time_point begin = benchclock::now();
+    for (uint32_t j = 0; j < numberOfJobs; j++) {
+        now += arrivalDistribution(random);
+
+        while (not running.empty() and running.top().first <= now) {
+            Job* finished = running.top().second;
+            running.pop();
+            benchclock::time_point start = benchclock::now();
+            table->deallocateJob(finished);
+            deallocate.add(start);
+        }
+
+        Job* job = new Job();
+        job->setJobNumber(j);
+        uint32_t cpus = 1 + sizeDistribution(random);
+        job->setNumberProcessors((cpus > numberOfNodes * cpusPerNode) ? numberOfNodes * cpusPerNode : cpus);
+        double runtime = runtimeDistribution(random);
+        job->setRequestedTime(runtime);
+        job->setRunTime(runtime);
+        jobs.push_back(job);
+
+        benchclock::time_point start = benchclock::now();
+        double startTime = now;
+        ResourceJobAllocation* possible = table->findPossibleAllocation(job, startTime, runtime);
+        searches++;
+        while (possible->getAllocationProblem()) {
+            startTime = possible->getNextStartTimeToExplore();
+            delete possible;
+            possible = table->findPossibleAllocation(job, startTime, runtime);
+            searches++;
+        }
+        ResourceJobAllocation* allocation = selectFirstFit(job, possible);
+        lookup.add(start);
+
+        start = benchclock::now();
+        table->allocateJob(job, allocation);
+        allocate.add(start);
+
+        sumOfWaits += startTime - now;
+        running.push(Finish(startTime + runtime, job));
+    }
+    double total = chrono::duration<double>(benchclock::now() - begin).count();
+
+    cout << numberOfNodes << " nodes of " << cpusPerNode << " cpus, " << numberOfJobs << " jobs, seed " << seed << endl;
+    lookup.print("lookup");
+    allocate.print("allocate");
+    deallocate.print("deallocate");
+    cout << "  " << searches << " searches, " << fixed << setprecision(3) << lookup.seconds * 1e6 / searches << " us/search" << endl;
+    cout << "  total " << total << " s, mean wait " << sumOfWaits / numberOfJobs << " s" << endl;
+
+    while (not running.empty()) {
+        table->deallocateJob(running.top().second);
+        running.pop();
+    }
+    delete table;
+    for (uint32_t i = 0; i < jobs.size(); i++)
+        delete jobs[i];
+    for (uint32_t i = 0; i < nodes.size(); i++)
+        delete nodes[i];
+    delete log;
+    return 0;
+}
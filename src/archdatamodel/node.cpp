@@ -51,7 +51,10 @@ Node::Node(const Node &n) {
 	inPartitionList = n.getPartitionList();
 }
 
-Node::~Node() {}
+Node::~Node() {
+	for(unsigned int i = 0; i < resources.size(); i++)
+		delete resources[i];
+}
 
 void Node::addResource(Resource *r) {
 	resources.push_back(r);
@@ -41,6 +41,7 @@
 #include "scheduling/partition.h"
 #include <utils/otf2trace.h>
 #include <utils/trace.h>
+#include <utils/simulationsweep.h>
 
 #include <getopt.h>
 
@@ -57,6 +58,7 @@ void show_help() throw () {
     cout << "  -h, --help                              display this help and exit" << endl;
     cout << "  -s<file>, --simconfig=<file>            use <file> as simulation configuration file." << endl;
     cout << "  -d[debuglevel], --debug[=<debuglevel>]  enable debug mode and optionally specify <debuglevel>." << endl;
+    cout << "  -w<file>, --sweep=<file>                run the sweep defined in <file> over the simulation configuration." << endl;
     //cout << "  -r<path>, --root=<path>                 specify <path> as location of root NEXTGenSim directory." << endl;
     cout << "" << endl;
     cout << "Environment Variables:" << endl;
@@ -124,17 +126,13 @@ const char * optname( const int code, const Arg_parser::Option options[] ) throw
 
 
 
-/* WE KEEP THIS AS A GLOBAL FOR THE SIGNAL TREATMENT */
-Simulator::Simulation * simulator = NULL;
-
+/* THE SIGNALS ONLY LEAVE A REQUEST, THE SIMULATIONS SERVE IT BETWEEN TWO EVENTS */
 void terminate(int param) {
-    std::printf("Terminating simulation a sigkill has been received...\n");
-    std::printf("All the statistic files and traces are being generated..\n");
-    simulator->setStopSimulation(true);
+    Simulator::Simulation::requestStop();
 }
 
 void showStats(int param) {
-    simulator->showCurrentStatistics();
+    Simulator::Simulation::requestStatistics();
     signal(SIGINT, showStats);
 }
 
@@ -154,6 +152,7 @@ int main(int argc, char *argv[]) {
     double startime = 0;
     std::string ngsim_root;
     std::string simulationconfigurationfile;
+    std::string sweepfile;
 
 
     cout << "      _   _  _______   _______ _____            _____ _           " << endl;
@@ -174,13 +173,14 @@ int main(int argc, char *argv[]) {
             {"debug", optional_argument, NULL, 'd'},
             {"help", no_argument, NULL, 'h'},
             {"simconfig", required_argument, NULL, 's'},
+            {"sweep", required_argument, NULL, 'w'},
 //            {"root", required_argument, NULL, 'r'},
             {0, 0, 0}
         };
 
         int option_index = 0;
         int c = 0;
-        c = getopt_long(argc, argv, "hs:d::", long_options, &option_index);
+        c = getopt_long(argc, argv, "hs:w:d::", long_options, &option_index);
 
         if (c == -1) {
             break;
@@ -193,6 +193,7 @@ int main(int argc, char *argv[]) {
          * d (--debug) - debug PLUS setting the debug level
          * s (--simconfig) - location of a simulation configuration file
          * r (--root) - NGSIM_ROOT rather than define by an env var
+         * w (--sweep) - location of a sweep definition, runs the simulation configuration many times
          * 
          * Things we might want options for in the future...
          * Type of output file to generate (paraver/otf2)
@@ -246,6 +247,15 @@ int main(int argc, char *argv[]) {
                 }
                 break;
 
+            case 'w':
+                /* Sweep to run over the simulation configuration */
+                if (optarg == NULL) {
+                    cout << "Failure to specify a sweep." << endl;
+                } else {
+                    sweepfile = optarg;
+                }
+                break;
+
             default:
                 cout << "Unrecognised Options" << endl;
                 show_help();
@@ -300,10 +310,26 @@ int main(int argc, char *argv[]) {
     }
 
    log->beginFile(simConfig->ErrorFilePath, simConfig->DebugFilePath);
+    if (simConfig->DebugRingBufferSize > 0)
+        log->setRingBufferSize((size_t) simConfig->DebugRingBufferSize * 1024 * 1024);
+    else if (simConfig->DebugAsyncWriter)
+        log->startWriterThread();
+    Log::installCrashHandlers(log);
 
 
     simConfig->log = log;
 
+    if (!sweepfile.empty()) {
+        //every run of the sweep creates its own simulation from the configuration file, only the workload is shared
+        log->debug("Running the sweep " + sweepfile, 1);
+        signal(SIGUSR1, terminate);
+        signal(SIGINT, showStats);
+        Utils::SimulationSweep sweep(sweepfile, simulationconfigurationfile, log);
+        bool saved = sweep.run();
+        log->flush();
+        return saved ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     //Now that the we have parsed all the parameters and the configuration file has been loaded we 
     //carry out all the simulation stuff related to the simulation
     //also the parameters provided by command line have more priority to the once provided by xml
@@ -323,6 +349,7 @@ int main(int argc, char *argv[]) {
     log->debug("Architecture created.", 1);
     Simulator::SystemOrchestrator *sysOrch = architectureConfig->getSystemOrchestrator();
     sysOrch->setSimulatePartitions(simConfig->simPartitions);
+    sysOrch->setPartitionThreads((simConfig->partitionThreads > 1) ? simConfig->partitionThreads : 1);
     sysOrch->setGlobalTime(startime);
     sysOrch->setOutputTrace(simConfig->generateOutputTrace);
     sysOrch->setsimuConfig(simConfig);
@@ -334,6 +361,8 @@ int main(int argc, char *argv[]) {
     Simulator::SchedulingPolicy *policy = simConfig->CreatePolicy(architectureConfig, log, startime);
     sysOrch->setPolicy((ResourceSchedulingPolicy*) policy);
     sysOrch->setReserveFullNode(simConfig->reserveFullNode);
+    sysOrch->setNodePools(simConfig->nodePools);
+    sysOrch->setEarliestStartSearch(simConfig->earliestStartSearch);
 
     log->debug("The sysOrch has paraver set to " + itos(sysOrch->getOutputTrace()), 1);
     //if 
@@ -383,7 +412,7 @@ int main(int argc, char *argv[]) {
 
     log->debug("Creating the simulator...");
 
-    simulator = new Simulation(chars, log, sysOrch);
+    Simulation* simulator = new Simulation(chars, log, sysOrch);
     log->setglobalTimeref(simulator->getGlobalTimeRef());
 
 
@@ -393,6 +422,10 @@ int main(int argc, char *argv[]) {
     simulator->setPolicySimulationPerformance(policySimulationCSV);
     simulator->setShowSimulationProgress(simConfig->showSimulationProgress);
     simulator->setSlowdownBound(simConfig->SlowdownBound);
+    simulator->setEventQueueType(simConfig->eventQueueType);
+    simulator->setBackfillInterval(simConfig->SLURMBackfillInterval);
+    simulator->setPartitionEventStreams(simConfig->partitionEventStreams);
+    simulator->setPartitionLookahead(simConfig->partitionLookahead);
 
     sysOrch->setSim(simulator);
 
@@ -468,6 +501,7 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    log->flush();
     return EXIT_SUCCESS;
 }
 
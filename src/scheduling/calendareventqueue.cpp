@@ -0,0 +1,177 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/calendareventqueue.h>
+
+#include <math.h>
+
+namespace Simulator {
+
+    /**
+     * The default constructor for the class
+     */
+    CalendarEventQueue::CalendarEventQueue() : slots(CALENDAR_EVENT_QUEUE_SLOTS) {
+        this->base = 0;
+        this->wheelEvents = 0;
+        this->head = NULL;
+    }
+
+    /**
+     * The default destructor for the class. The events are owned by the simulation, they are not deleted here.
+     */
+    CalendarEventQueue::~CalendarEventQueue() {
+    }
+
+    /**
+     * Inserts a new event in the queue
+     * @param event The event to be inserted
+     */
+    void CalendarEventQueue::insert(SimulationEvent* event) {
+        //the simulation never inserts events before the head it has just treated, but an event may go before a cancelled head
+        if (this->getSecond(event) < this->base)
+            this->rewind(this->getSecond(event));
+        HeapEventQueue* slot = this->getSlot(event);
+        slot->insert(event);
+        if (slot != &this->overflow)
+            this->wheelEvents++;
+        if (this->head != NULL && this->before(event, this->head))
+            this->head = event;
+    }
+
+    /**
+     * Removes an event from the queue. The event is not deleted. When the head is removed the wheel advances to its second.
+     * @param event The event to be removed, it must be queued
+     */
+    void CalendarEventQueue::erase(SimulationEvent* event) {
+        HeapEventQueue* slot = this->getSlot(event);
+        slot->erase(event);
+        if (slot != &this->overflow)
+            this->wheelEvents--;
+        if (event == this->head) {
+            this->head = NULL;
+            this->advance(this->getSecond(event));
+        }
+    }
+
+    /**
+     * Returns the event at the head of the queue
+     * @return The next event to be treated, NULL if the queue is empty
+     */
+    SimulationEvent* CalendarEventQueue::top() const {
+        if (this->head != NULL)
+            return this->head;
+        if (this->wheelEvents == 0)
+            return this->head = this->overflow.top();
+        for (uint64_t second = this->base;; second++) {
+            const HeapEventQueue& slot = this->slots[second & (CALENDAR_EVENT_QUEUE_SLOTS - 1)];
+            if (!slot.empty())
+                return this->head = slot.top();
+        }
+    }
+
+    /**
+     * Indicates if the event is stored in this queue
+     * @param event The event to check
+     * @return True if the event is queued
+     */
+    bool CalendarEventQueue::contains(SimulationEvent* event) const {
+        if (this->getSecond(event) < this->base)
+            return false;
+        return this->getSlot(event)->contains(event);
+    }
+
+    /**
+     * Returns the number of pending events
+     * @return The size of the queue
+     */
+    size_t CalendarEventQueue::size() const {
+        return this->wheelEvents + this->overflow.size();
+    }
+
+    /**
+     * Appends the pending events, in no particular order, to the given vector
+     * @param events The vector where the events are stored
+     */
+    void CalendarEventQueue::getEvents(vector<SimulationEvent*>& events) const {
+        for (vector<HeapEventQueue>::const_iterator it = this->slots.begin(); it != this->slots.end(); ++it)
+            it->getEvents(events);
+        this->overflow.getEvents(events);
+    }
+
+    /**
+     * Returns the second when the event is triggered
+     * @param event The event
+     * @return The time of the event rounded down to the second
+     */
+    uint64_t CalendarEventQueue::getSecond(SimulationEvent* event) const {
+        assert(event->getTime() >= 0);
+        return (uint64_t) floor(event->getTime());
+    }
+
+    /**
+     * Returns the heap where the event is, or would be, stored
+     * @param event The event
+     * @return The slot of the wheel for the second of the event, or the overflow heap
+     */
+    HeapEventQueue* CalendarEventQueue::getSlot(SimulationEvent* event) {
+        uint64_t second = this->getSecond(event);
+        if (second - this->base < CALENDAR_EVENT_QUEUE_SLOTS)
+            return &this->slots[second & (CALENDAR_EVENT_QUEUE_SLOTS - 1)];
+        return &this->overflow;
+    }
+
+    const HeapEventQueue* CalendarEventQueue::getSlot(SimulationEvent* event) const {
+        return const_cast<CalendarEventQueue*> (this)->getSlot(event);
+    }
+
+    /**
+     * Moves the wheel so it starts at the given second. The overflow events that fall in the new window are moved to their slot.
+     * @param second The new first second of the wheel
+     */
+    void CalendarEventQueue::advance(uint64_t second) {
+        if (second <= this->base)
+            return;
+        this->base = second;
+        while (!this->overflow.empty() && this->getSecond(this->overflow.top()) - this->base < CALENDAR_EVENT_QUEUE_SLOTS) {
+            SimulationEvent* event = this->overflow.top();
+            this->overflow.erase(event);
+            this->slots[this->getSecond(event) & (CALENDAR_EVENT_QUEUE_SLOTS - 1)].insert(event);
+            this->wheelEvents++;
+        }
+    }
+
+    /**
+     * Moves the wheel back so it starts at the given second. The events that fall out of the new window are moved to the overflow heap.
+     * @param second The new first second of the wheel
+     */
+    void CalendarEventQueue::rewind(uint64_t second) {
+        assert(second < this->base);
+        this->base = second;
+        for (vector<HeapEventQueue>::iterator it = this->slots.begin(); it != this->slots.end(); ++it) {
+            while (!it->empty() && this->getSecond(it->top()) - this->base >= CALENDAR_EVENT_QUEUE_SLOTS) {
+                SimulationEvent* event = it->top();
+                it->erase(event);
+                this->overflow.insert(event);
+                this->wheelEvents--;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,66 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATORCALENDAREVENTQUEUE_H
+#define SIMULATORCALENDAREVENTQUEUE_H
+
+/** Number of one second slots of the calendar wheel, it must be a power of two */
+#define CALENDAR_EVENT_QUEUE_SLOTS 4096
+
+#include <scheduling/heapeventqueue.h>
+#include <stdint.h>
+
+namespace Simulator {
+
+    /**
+     * Event queue implemented as a timing wheel of one second slots. The events of the next CALENDAR_EVENT_QUEUE_SLOTS seconds
+     * are stored in the slot of the second they are triggered, the rest wait in an overflow heap until the wheel reaches them.
+     * Each slot is a small heap ordered with eventorder_t, so events with fractional times and events that share a second are
+     * treated exactly in the same order as with the HeapEventQueue.
+     */
+    class CalendarEventQueue : public EventQueue {
+    public:
+        CalendarEventQueue();
+        ~CalendarEventQueue();
+
+        void insert(SimulationEvent* event) override;
+        void erase(SimulationEvent* event) override;
+        SimulationEvent* top() const override;
+        bool contains(SimulationEvent* event) const override;
+        size_t size() const override;
+        void getEvents(vector<SimulationEvent*>& events) const override;
+
+    private:
+        uint64_t getSecond(SimulationEvent* event) const;
+        HeapEventQueue* getSlot(SimulationEvent* event);
+        const HeapEventQueue* getSlot(SimulationEvent* event) const;
+        void advance(uint64_t second);
+        void rewind(uint64_t second);
+
+        vector<HeapEventQueue> slots; /**< The slots of the wheel, the second s is stored in the slot s % CALENDAR_EVENT_QUEUE_SLOTS */
+        HeapEventQueue overflow; /**< The events that are too far in the future to be stored in the wheel */
+        uint64_t base; /**< The first second covered by the wheel */
+        size_t wheelEvents; /**< The number of events stored in the wheel */
+        mutable SimulationEvent* head; /**< The head of the queue if it is already known, NULL otherwise */
+    };
+
+}
+
+#endif
@@ -0,0 +1,438 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/capacityprofile.h>
+
+#include <assert.h>
+
+namespace Simulator {
+
+    /**
+     * The constructor for the class. The profile starts with a single step without any resource, they are added as
+     * the nodes join the system.
+     * @param startTime The first time of the profile
+     */
+    CapacityProfile::CapacityProfile(double startTime) {
+        this->seed = 2463534242u;
+        this->root = this->newStep(startTime, 0, 0);
+        this->firstTime = startTime;
+    }
+
+    /**
+     * The default destructor for the class
+     */
+    CapacityProfile::~CapacityProfile() {
+    }
+
+    /**
+     * Adds the resources of a new node to the whole profile
+     * @param cpus The cpus of the node
+     * @param memory The memory of the node
+     */
+    void CapacityProfile::addCapacity(int64_t cpus, int64_t memory) {
+        this->apply(this->root, cpus, memory);
+    }
+
+    /**
+     * Substracts the resources of a reservation from the steps between startTime and endTime
+     * @param startTime The first time of the reservation
+     * @param endTime The last time of the reservation
+     * @param cpus The reserved cpus
+     * @param memory The reserved memory
+     */
+    void CapacityProfile::reserve(double startTime, double endTime, uint32_t cpus, uint64_t memory) {
+        this->change(startTime, endTime, -(int64_t) cpus, -(int64_t) memory);
+    }
+
+    /**
+     * Gives back the resources of a reservation done with reserve
+     * @param startTime The first time of the reservation
+     * @param endTime The last time of the reservation
+     * @param cpus The reserved cpus
+     * @param memory The reserved memory
+     */
+    void CapacityProfile::release(double startTime, double endTime, uint32_t cpus, uint64_t memory) {
+        this->change(startTime, endTime, (int64_t) cpus, (int64_t) memory);
+    }
+
+    /**
+     * Returns the first time, not before the given one, when the system has at least the given cpus and memory free
+     * during length. The nodes may still be too fragmented to hold the job at that time, but it can not start before.
+     * @param time The first time to consider
+     * @param length The length of the job
+     * @param cpus The cpus required
+     * @param memory The memory required
+     * @return The earliest start time, -1 if the system never has enough resources
+     */
+    double CapacityProfile::findEarliestStart(double time, double length, uint32_t cpus, uint64_t memory) {
+        int64_t needCPUs = cpus;
+        int64_t needMemory = memory;
+
+        while (true) {
+            int32_t current = this->findStep(time, false);
+            if (current == -1) {
+                //times before the profile are as the first step
+                current = this->findFirstFitting(this->root, time, needCPUs, needMemory);
+                if (current == -1)
+                    return -1;
+                time = this->steps[current].time;
+            }
+
+            if (this->steps[current].freeCPUs < needCPUs or this->steps[current].freeMemory < needMemory) {
+                //jump to the first step after the current one with enough resources
+                int32_t next = this->findFirstFitting(this->root, time, needCPUs, needMemory);
+                if (next == -1)
+                    return -1;
+                time = this->steps[next].time;
+            }
+
+            //the resources must be there until the job finishes, the first step that lacks them is the next candidate
+            int32_t blocking = this->findFirstBlocking(this->root, time, time + length, needCPUs, needMemory);
+            if (blocking == -1)
+                return time;
+            time = this->steps[blocking].time;
+        }
+    }
+
+    /**
+     * Removes the steps that are before time, the step that contains time begins at it afterwards.
+     * @param time The time before which the steps are not needed anymore
+     */
+    void CapacityProfile::trim(double time) {
+        if (time <= this->firstTime)
+            return;
+
+        this->ensureStep(time);
+        int32_t past;
+        this->split(this->root, time, past, this->root);
+        this->recycle(past);
+        this->firstTime = time;
+    }
+
+    /**
+     * Returns the number of steps of the profile
+     * @return The number of steps
+     */
+    size_t CapacityProfile::getNumberOfSteps() const {
+        return this->steps.size() - this->unusedSteps.size();
+    }
+
+    /**
+     * Adds resources to the steps between startTime and endTime, splitting the steps at both ends. Steps that finish
+     * with the same resources as the previous one are joined.
+     * @param startTime The first time to change
+     * @param endTime The last time to change
+     * @param cpus The cpus to add, negative to substract them
+     * @param memory The memory to add, negative to substract it
+     */
+    void CapacityProfile::change(double startTime, double endTime, int64_t cpus, int64_t memory) {
+        assert(startTime <= endTime);
+        if (startTime < this->firstTime)
+            startTime = this->firstTime;
+        if (endTime < startTime) //the whole change is in the trimmed past
+            return;
+        this->ensureStep(startTime);
+        this->ensureStep(endTime + 1);
+
+        int32_t before, middle, after;
+        this->split(this->root, startTime, before, middle);
+        this->split(middle, endTime + 1, middle, after);
+        this->apply(middle, cpus, memory);
+        assert(middle == -1 or (this->steps[middle].minCPUs >= 0 and this->steps[middle].minMemory >= 0));
+        this->root = this->merge(before, this->merge(middle, after));
+
+        this->removeRedundantStep(endTime + 1);
+        this->removeRedundantStep(startTime);
+    }
+
+    /**
+     * Makes sure that a step begins at the given time, splitting the step that contains it
+     * @param time The time
+     */
+    void CapacityProfile::ensureStep(double time) {
+        int32_t step = this->findStep(time, false);
+        assert(step != -1);
+        if (this->steps[step].time == time)
+            return;
+
+        int32_t created = this->newStep(time, this->steps[step].freeCPUs, this->steps[step].freeMemory);
+        int32_t left, right;
+        this->split(this->root, time, left, right);
+        this->root = this->merge(left, this->merge(created, right));
+    }
+
+    /**
+     * Removes the step that begins at the given time if the previous step has the same resources
+     * @param time The time
+     */
+    void CapacityProfile::removeRedundantStep(double time) {
+        int32_t step = this->findStep(time, false);
+        if (step == -1 or this->steps[step].time != time)
+            return;
+        int32_t previous = this->findStep(time, true);
+        if (previous == -1)
+            return;
+
+        if (this->steps[previous].freeCPUs == this->steps[step].freeCPUs and this->steps[previous].freeMemory == this->steps[step].freeMemory)
+            this->root = this->erase(this->root, time);
+    }
+
+    /**
+     * Looks for the last step that begins before or at the given time. The pending resources of the path are pushed,
+     * so the resources of the step returned are up to date.
+     * @param time The time
+     * @param strict If true, the step has to begin before the time
+     * @return The step, -1 if there is none
+     */
+    int32_t CapacityProfile::findStep(double time, bool strict) {
+        int32_t found = -1;
+        int32_t step = this->root;
+        while (step != -1) {
+            this->push(step);
+            bool before = strict ? this->steps[step].time < time : this->steps[step].time <= time;
+            if (before) {
+                found = step;
+                step = this->steps[step].right;
+            } else {
+                step = this->steps[step].left;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * Looks in a subtree for the first step that begins after the time after and not later than until and lacks the given resources
+     * @param step The root of the subtree
+     * @param after The time that the step has to follow
+     * @param until The last time that the step can begin
+     * @param cpus The cpus required
+     * @param memory The memory required
+     * @return The step, -1 if there is none
+     */
+    int32_t CapacityProfile::findFirstBlocking(int32_t step, double after, double until, int64_t cpus, int64_t memory) {
+        if (step == -1 or (this->steps[step].minCPUs >= cpus and this->steps[step].minMemory >= memory))
+            return -1;
+
+        this->push(step);
+        if (this->steps[step].time > after) {
+            int32_t found = this->findFirstBlocking(this->steps[step].left, after, until, cpus, memory);
+            if (found != -1)
+                return found;
+            if (this->steps[step].time > until)
+                return -1;
+            if (this->steps[step].freeCPUs < cpus or this->steps[step].freeMemory < memory)
+                return step;
+        }
+        return this->findFirstBlocking(this->steps[step].right, after, until, cpus, memory);
+    }
+
+    /**
+     * Looks in a subtree for the first step that begins after the given time and has the given resources
+     * @param step The root of the subtree
+     * @param after The time that the step has to follow
+     * @param cpus The cpus required
+     * @param memory The memory required
+     * @return The step, -1 if there is none
+     */
+    int32_t CapacityProfile::findFirstFitting(int32_t step, double after, int64_t cpus, int64_t memory) {
+        if (step == -1 or this->steps[step].maxCPUs < cpus or this->steps[step].maxMemory < memory)
+            return -1;
+
+        this->push(step);
+        if (this->steps[step].time > after) {
+            int32_t found = this->findFirstFitting(this->steps[step].left, after, cpus, memory);
+            if (found != -1)
+                return found;
+            if (this->steps[step].freeCPUs >= cpus and this->steps[step].freeMemory >= memory)
+                return step;
+        }
+        return this->findFirstFitting(this->steps[step].right, after, cpus, memory);
+    }
+
+    /**
+     * Creates a step without children, reusing the storage of a removed one when possible
+     * @param time The time when the step begins
+     * @param cpus The free cpus of the step
+     * @param memory The free memory of the step
+     * @return The position of the step
+     */
+    int32_t CapacityProfile::newStep(double time, int64_t cpus, int64_t memory) {
+        //xorshift, the priorities only have to be spread to keep the treap balanced
+        this->seed ^= this->seed << 13;
+        this->seed ^= this->seed >> 17;
+        this->seed ^= this->seed << 5;
+
+        CapacityStep step = {.time = time, .freeCPUs = cpus, .freeMemory = memory,
+            .minCPUs = cpus, .minMemory = memory, .maxCPUs = cpus, .maxMemory = memory,
+            .pendingCPUs = 0, .pendingMemory = 0, .priority = this->seed, .left = -1, .right = -1};
+
+        if (not this->unusedSteps.empty()) {
+            int32_t pos = this->unusedSteps.back();
+            this->unusedSteps.pop_back();
+            this->steps[pos] = step;
+            return pos;
+        }
+        this->steps.push_back(step);
+        return this->steps.size() - 1;
+    }
+
+    /**
+     * Adds resources to all the steps of a subtree. Only the root of the subtree is updated, the children
+     * get them when the root is pushed.
+     * @param step The root of the subtree
+     * @param cpus The cpus to add
+     * @param memory The memory to add
+     */
+    void CapacityProfile::apply(int32_t step, int64_t cpus, int64_t memory) {
+        if (step == -1)
+            return;
+        CapacityStep& s = this->steps[step];
+        s.freeCPUs += cpus;
+        s.freeMemory += memory;
+        s.minCPUs += cpus;
+        s.minMemory += memory;
+        s.maxCPUs += cpus;
+        s.maxMemory += memory;
+        s.pendingCPUs += cpus;
+        s.pendingMemory += memory;
+    }
+
+    /**
+     * Gives the pending resources of a step to its children
+     * @param step The step
+     */
+    void CapacityProfile::push(int32_t step) {
+        CapacityStep& s = this->steps[step];
+        if (s.pendingCPUs == 0 and s.pendingMemory == 0)
+            return;
+        this->apply(s.left, s.pendingCPUs, s.pendingMemory);
+        this->apply(s.right, s.pendingCPUs, s.pendingMemory);
+        s.pendingCPUs = 0;
+        s.pendingMemory = 0;
+    }
+
+    /**
+     * Computes the minimum and maximum of a subtree from the ones of its children, which must be up to date
+     * @param step The root of the subtree
+     */
+    void CapacityProfile::update(int32_t step) {
+        CapacityStep& s = this->steps[step];
+        s.minCPUs = s.maxCPUs = s.freeCPUs;
+        s.minMemory = s.maxMemory = s.freeMemory;
+        int32_t children[2] = {s.left, s.right};
+        for (int i = 0; i < 2; i++) {
+            if (children[i] == -1)
+                continue;
+            const CapacityStep& child = this->steps[children[i]];
+            s.minCPUs = (child.minCPUs < s.minCPUs) ? child.minCPUs : s.minCPUs;
+            s.minMemory = (child.minMemory < s.minMemory) ? child.minMemory : s.minMemory;
+            s.maxCPUs = (child.maxCPUs > s.maxCPUs) ? child.maxCPUs : s.maxCPUs;
+            s.maxMemory = (child.maxMemory > s.maxMemory) ? child.maxMemory : s.maxMemory;
+        }
+    }
+
+    /**
+     * Splits a subtree in the steps that begin before the time and the rest
+     * @param step The root of the subtree
+     * @param time The time
+     * @param left Returns the subtree with the steps before the time
+     * @param right Returns the subtree with the steps at or after the time
+     */
+    void CapacityProfile::split(int32_t step, double time, int32_t& left, int32_t& right) {
+        if (step == -1) {
+            left = right = -1;
+            return;
+        }
+        this->push(step);
+        if (this->steps[step].time < time) {
+            int32_t l, r;
+            this->split(this->steps[step].right, time, l, r);
+            this->steps[step].right = l;
+            left = step;
+            right = r;
+        } else {
+            int32_t l, r;
+            this->split(this->steps[step].left, time, l, r);
+            this->steps[step].left = r;
+            left = l;
+            right = step;
+        }
+        this->update(step);
+    }
+
+    /**
+     * Joins two subtrees, all the steps of left must begin before the ones of right
+     * @param left The subtree with the first steps
+     * @param right The subtree with the last steps
+     * @return The root of the joined subtree
+     */
+    int32_t CapacityProfile::merge(int32_t left, int32_t right) {
+        if (left == -1)
+            return right;
+        if (right == -1)
+            return left;
+
+        if (this->steps[left].priority > this->steps[right].priority) {
+            this->push(left);
+            this->steps[left].right = this->merge(this->steps[left].right, right);
+            this->update(left);
+            return left;
+        }
+        this->push(right);
+        this->steps[right].left = this->merge(left, this->steps[right].left);
+        this->update(right);
+        return right;
+    }
+
+    /**
+     * Marks all the steps of a subtree as unused
+     * @param step The root of the subtree
+     */
+    void CapacityProfile::recycle(int32_t step) {
+        if (step == -1)
+            return;
+        this->recycle(this->steps[step].left);
+        this->recycle(this->steps[step].right);
+        this->unusedSteps.push_back(step);
+    }
+
+    /**
+     * Removes from a subtree the step that begins at the given time
+     * @param step The root of the subtree
+     * @param time The time of the step to remove
+     * @return The new root of the subtree
+     */
+    int32_t CapacityProfile::erase(int32_t step, double time) {
+        assert(step != -1);
+        this->push(step);
+        if (this->steps[step].time == time) {
+            int32_t joined = this->merge(this->steps[step].left, this->steps[step].right);
+            this->unusedSteps.push_back(step);
+            return joined;
+        }
+        if (time < this->steps[step].time)
+            this->steps[step].left = this->erase(this->steps[step].left, time);
+        else
+            this->steps[step].right = this->erase(this->steps[step].right, time);
+        this->update(step);
+        return step;
+    }
+
+}
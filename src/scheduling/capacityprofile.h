@@ -0,0 +1,96 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATORCAPACITYPROFILE_H
+#define SIMULATORCAPACITYPROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+using std::vector;
+
+namespace Simulator {
+
+    /**
+     * A step of the capacity profile: from its time until the time of the next step the whole system has the same free
+     * cpus and memory. The steps are the nodes of a treap sorted by time, every node keeps the minimum and maximum of
+     * its subtree and the amount of resources that still has to be added to its children.
+     */
+    struct CapacityStep {
+        double time; /**< The time when the step begins */
+        int64_t freeCPUs; /**< The free cpus of all the nodes along the step */
+        int64_t freeMemory; /**< The free memory of all the nodes along the step */
+        int64_t minCPUs; /**< The minimum freeCPUs of the subtree */
+        int64_t minMemory; /**< The minimum freeMemory of the subtree */
+        int64_t maxCPUs; /**< The maximum freeCPUs of the subtree */
+        int64_t maxMemory; /**< The maximum freeMemory of the subtree */
+        int64_t pendingCPUs; /**< The cpus to add to the children of the step */
+        int64_t pendingMemory; /**< The memory to add to the children of the step */
+        uint32_t priority; /**< The heap priority of the treap */
+        int32_t left; /**< The step with the previous times, -1 if none */
+        int32_t right; /**< The step with the next times, -1 if none */
+    };
+
+    /**
+     * The free cpus and memory of the whole system along the time. It is the sum of the timelines of all the nodes and it
+     * is used to know the earliest time when a job could start without looking at every node: before that time there are
+     * not enough resources in the system, whatever the nodes are. Reserving, releasing and looking for the earliest start
+     * are logarithmic in the number of steps. The steps of the past can be trimmed.
+     */
+    class CapacityProfile {
+    public:
+        CapacityProfile(double startTime);
+        ~CapacityProfile();
+
+        void addCapacity(int64_t cpus, int64_t memory);
+        void reserve(double startTime, double endTime, uint32_t cpus, uint64_t memory);
+        void release(double startTime, double endTime, uint32_t cpus, uint64_t memory);
+        double findEarliestStart(double time, double length, uint32_t cpus, uint64_t memory);
+        void trim(double time);
+        size_t getNumberOfSteps() const;
+
+    private:
+        void change(double startTime, double endTime, int64_t cpus, int64_t memory);
+        void ensureStep(double time);
+        void removeRedundantStep(double time);
+        int32_t findStep(double time, bool strict);
+        int32_t findFirstBlocking(int32_t step, double after, double until, int64_t cpus, int64_t memory);
+        int32_t findFirstFitting(int32_t step, double after, int64_t cpus, int64_t memory);
+
+        int32_t newStep(double time, int64_t cpus, int64_t memory);
+        void apply(int32_t step, int64_t cpus, int64_t memory);
+        void push(int32_t step);
+        void update(int32_t step);
+        void split(int32_t step, double time, int32_t& left, int32_t& right);
+        int32_t merge(int32_t left, int32_t right);
+        int32_t erase(int32_t step, double time);
+        void recycle(int32_t step);
+
+        vector<CapacityStep> steps; /**< The storage of the steps, the unused ones are listed in unusedSteps */
+        vector<int32_t> unusedSteps; /**< The positions of steps that can be reused */
+        int32_t root; /**< The root of the treap */
+        double firstTime; /**< The time of the first step, the reservations that began before are taken as beginning at it */
+        uint32_t seed; /**< The state of the generator of priorities */
+    };
+
+}
+
+#endif
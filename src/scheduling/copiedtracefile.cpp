@@ -0,0 +1,74 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/copiedtracefile.h>
+#include <scheduling/job.h>
+
+namespace Simulator {
+
+/**
+ * The constructor for the class, copies the jobs of a workload that has already been loaded
+ * @param source The loaded workload, it is not modified
+ * @param log The logging engine
+ */
+CopiedTraceFile::CopiedTraceFile(TraceFile* source,Log* log) : TraceFile()
+{
+  this->filePath = source->getfilePath();
+  this->log = log;
+  this->lastArrival = source->getlastArrival();
+  this->JobsToLoad = source->getJobsToLoad();
+  this->LoadedJobs = source->getLoadedJobs();
+  this->LoadFromJob = source->getLoadFromJob();
+  this->LoadTillJob = source->getLoadTillJob();
+
+  for(map<int,Job*>::iterator it = source->JobList.begin(); it != source->JobList.end(); ++it)
+    this->JobList.insert(pairJob(it->first,it->second->clone()));
+
+  //the workflow links point to the jobs of the source
+  this->buildDependencies();
+}
+
+/**
+ * The destructor for the class, the copied jobs belong to the workload
+ */
+CopiedTraceFile::~CopiedTraceFile()
+{
+  for(map<int,Job*>::iterator it = this->JobList.begin(); it != this->JobList.end(); ++it)
+    delete it->second;
+}
+
+/**
+ * The jobs are copied when the workload is created
+ * @return True
+ */
+bool CopiedTraceFile::loadTrace()
+{
+  return true;
+}
+
+/**
+ * There is no header to process, the workload has no file
+ * @param headerLine The header line
+ */
+void CopiedTraceFile::processHeaderEntry(string headerLine)
+{
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef COPIEDTRACEFILE_H
+#define COPIEDTRACEFILE_H
+
+#include <scheduling/tracefile.h>
+#include <utils/log.h>
+
+using namespace Utils;
+
+namespace Simulator {
+
+/** A workload that is not read from a file but copied from another loaded workload. Every run of a sweep gets its own
+ * copy of the jobs, whose state is changed by the simulation, while the trace is parsed only once. */
+class CopiedTraceFile: public TraceFile {
+public:
+  CopiedTraceFile(TraceFile* source,Log* log);
+  ~CopiedTraceFile();
+
+  virtual bool loadTrace();
+  virtual void processHeaderEntry(string headerLine);
+};
+
+}
+#endif
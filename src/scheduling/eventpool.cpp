@@ -0,0 +1,111 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/eventpool.h>
+
+#include <assert.h>
+#include <new>
+#include <type_traits>
+
+namespace Simulator {
+
+    static_assert(std::is_trivially_copyable<SimulationEvent>::value, "the events are recycled without being destroyed");
+
+    /**
+     * The default constructor for the class
+     */
+    EventPool::EventPool() {
+        this->eventsInUse = 0;
+        this->highWaterMark = 0;
+    }
+
+    /**
+     * The default destructor for the class. All the events provided by the pool become invalid.
+     */
+    EventPool::~EventPool() {
+        for (vector<SimulationEvent*>::iterator it = this->slabs.begin(); it != this->slabs.end(); ++it)
+            ::operator delete(*it);
+    }
+
+    /**
+     * Returns a new event, taken from the free list if possible.
+     * @param type The event type
+     * @param job The job associated to the event
+     * @param id The id for event
+     * @param time The time associated to the event
+     * @return The event, it must be given back with releaseEvent instead of being deleted
+     */
+    SimulationEvent* EventPool::newEvent(event_t type, Job* job, int id, double time) {
+        if (this->freeEvents.empty())
+            this->allocateSlab();
+        SimulationEvent* event = this->freeEvents.back();
+        this->freeEvents.pop_back();
+        new (event) SimulationEvent(type, job, id, time);
+        this->eventsInUse++;
+        if (this->eventsInUse > this->highWaterMark)
+            this->highWaterMark = this->eventsInUse;
+        return event;
+    }
+
+    /**
+     * Gives back an event to the pool once it is not referenced any more.
+     * @param event The event to release
+     */
+    void EventPool::releaseEvent(SimulationEvent* event) {
+        assert(this->eventsInUse > 0);
+        this->eventsInUse--;
+        this->freeEvents.push_back(event);
+    }
+
+    /**
+     * Returns the number of events that are currently handed out
+     * @return The number of events in use
+     */
+    size_t EventPool::getEventsInUse() const {
+        return this->eventsInUse;
+    }
+
+    /**
+     * Returns the maximum number of events that have been in use at the same time
+     * @return The high-water mark of the pool
+     */
+    size_t EventPool::getHighWaterMark() const {
+        return this->highWaterMark;
+    }
+
+    /**
+     * Returns the number of slabs that the pool has allocated
+     * @return The number of slabs
+     */
+    size_t EventPool::getNumberOfSlabs() const {
+        return this->slabs.size();
+    }
+
+    /**
+     * Allocates a new slab of events and adds them to the free list. The events are handed out from the beginning of the slab.
+     */
+    void EventPool::allocateSlab() {
+        SimulationEvent* slab = static_cast<SimulationEvent*> (::operator new(sizeof (SimulationEvent) * EVENT_POOL_SLAB_SIZE));
+        this->slabs.push_back(slab);
+        for (int i = EVENT_POOL_SLAB_SIZE - 1; i >= 0; i--)
+            this->freeEvents.push_back(&slab[i]);
+    }
+
+}
@@ -0,0 +1,62 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATOREVENTPOOL_H
+#define SIMULATOREVENTPOOL_H
+
+/** Number of events that are allocated at once when the pool runs out of free events */
+#define EVENT_POOL_SLAB_SIZE 4096
+
+#include <scheduling/simulationevent.h>
+#include <vector>
+
+using namespace std;
+using std::vector;
+
+namespace Simulator {
+
+    /**
+     * Pool that provides the simulation events. The events are allocated in slabs and recycled through
+     * a free list once they have been treated, so the simulation does not go to the heap for every event.
+     */
+    class EventPool {
+    public:
+        EventPool();
+        ~EventPool();
+
+        SimulationEvent* newEvent(event_t type, Job* job, int id, double time);
+        void releaseEvent(SimulationEvent* event);
+
+        size_t getEventsInUse() const;
+        size_t getHighWaterMark() const;
+        size_t getNumberOfSlabs() const;
+
+    private:
+        void allocateSlab();
+
+        vector<SimulationEvent*> slabs; /**< The blocks of EVENT_POOL_SLAB_SIZE events owned by the pool */
+        vector<SimulationEvent*> freeEvents; /**< The events that can be handed out again */
+        size_t eventsInUse; /**< The number of events that have been handed out and not released yet */
+        size_t highWaterMark; /**< The maximum number of events that have been in use at the same time */
+    };
+
+}
+
+#endif
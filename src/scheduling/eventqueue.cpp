@@ -0,0 +1,63 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/eventqueue.h>
+
+#include <algorithm>
+
+namespace Simulator {
+
+    /**
+     * The default destructor for the class. The events are owned by the simulation, they are not deleted here.
+     */
+    EventQueue::~EventQueue() {
+    }
+
+    /**
+     * Removes the event at the head of the queue
+     * @return The removed event, NULL if the queue is empty
+     */
+    SimulationEvent* EventQueue::pop() {
+        SimulationEvent* head = this->top();
+        if (head != NULL)
+            this->erase(head);
+        return head;
+    }
+
+    /**
+     * Indicates if there are no pending events
+     * @return True if the queue is empty
+     */
+    bool EventQueue::empty() const {
+        return this->size() == 0;
+    }
+
+    /**
+     * Returns a copy of the pending events sorted in the order that they will be treated. This is costly, it is intended for debugging.
+     * @return The vector with the sorted events
+     */
+    vector<SimulationEvent*> EventQueue::getOrderedEvents() const {
+        vector<SimulationEvent*> ordered;
+        this->getEvents(ordered);
+        sort(ordered.begin(), ordered.end(), this->before);
+        return ordered;
+    }
+
+}
@@ -0,0 +1,133 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATOREVENTQUEUE_H
+#define SIMULATOREVENTQUEUE_H
+
+#include <scheduling/simulationevent.h>
+#include <assert.h>
+#include <vector>
+
+using namespace std;
+using std::vector;
+
+namespace Simulator {
+
+    /** Struct that contains the lessthan operator that is used in the EventQueue type. The jobs are ordered by its time, and in case equal time, the events are ordered by its ide   */
+    struct eventorder_t {
+
+        bool operator()(SimulationEvent* event1, SimulationEvent* event2) const {
+
+            /*
+             * TRUE means event 1 goes closer to the head of the queue
+             * FALSE means event 2 goes closer to the head of the queue
+             */
+
+            volatile double e1time = event1->getTime();
+            volatile double e2time = event2->getTime();
+            assert(e1time >= 0 && e2time >= 0);
+
+            /* 
+             * Simple case, if event 1 occurs before event 2.
+             */
+            if (e1time < e2time)
+                return true;
+
+            /* 
+             * Simple case, if event 2 occurs before event 1.
+             */
+
+            if (e2time < e1time)
+                return false;
+
+            /*
+             * Complex case, if both events occur at the same time.
+             * We have to rank on priority according to event type, with SCHEDULE always being the loser.
+             */
+            if (e1time == e2time) {
+                if (event1->getType() == EVENT_SCHEDULE && event2->getType() != EVENT_SCHEDULE) {
+                    return false;
+                } else if (event1->getType() != EVENT_SCHEDULE && event2->getType() == EVENT_SCHEDULE) {
+                    return true;
+                } else {
+                    return event1->getid() < event2->getid();
+                }
+            }
+
+            //else if( (event1->getType() == EVENT_START) && (event2->getType() == EVENT_START))
+            //	return false;
+            //else if( event1->getType() == EVENT_START ) {
+            //		return true;
+            //}
+
+            //	return true;
+            //else if( event2->getType() == EVENT_START )
+            //	return true;
+            //	else if(event1->getType() == EVENT_TERMINATION && event2->getType() == EVENT_ARRIVAL)
+            /* in case that two events occurs at the same time, we priorize the jobs that free processors as Dan in SimEasy*/
+            //	   return true;
+            //	else if (event1->getType() == EVENT_ARRIVAL && event2->getType() == EVENT_START)
+            /* in case that two events occurs at the same time, we priorize the event that is a event arrival due to is preferable to schedule again*/
+            //	   return true;
+
+            // If we don't know, just pick event 1.
+            return true;
+        }
+    };
+
+    /** Struct that orders events stored by value (not queued yet) exactly as eventorder_t orders the queued ones */
+    struct eventvalueorder_t {
+
+        bool operator()(SimulationEvent event1, SimulationEvent event2) const {
+            return eventorder_t()(&event1, &event2);
+        }
+    };
+
+    /** The available implementations of the event queue */
+    enum event_queue_type_t {
+        HEAP_EVENT_QUEUE = 0,
+        CALENDAR_EVENT_QUEUE,
+    };
+
+    /**
+     * Event queue that stores the pending events. The implementations must treat the events in the order given by eventorder_t,
+     * and must be able to remove any queued event without searching for it.
+     */
+    class EventQueue {
+    public:
+        virtual ~EventQueue();
+
+        virtual void insert(SimulationEvent* event) = 0;
+        virtual void erase(SimulationEvent* event) = 0;
+        virtual SimulationEvent* top() const = 0;
+        virtual bool contains(SimulationEvent* event) const = 0;
+        virtual size_t size() const = 0;
+        virtual void getEvents(vector<SimulationEvent*>& events) const = 0;
+        SimulationEvent* pop();
+        bool empty() const;
+        vector<SimulationEvent*> getOrderedEvents() const;
+
+    protected:
+        eventorder_t before; /**< The ordering of the events, the same one that was used with the old set based queue */
+    };
+
+}
+
+#endif
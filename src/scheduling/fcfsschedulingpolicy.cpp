@@ -25,6 +25,8 @@
 
 
 #include <scheduling/simulation.h>
+#include <scheduling/systemorchestrator.h>
+#include <utils/simulationconfiguration.h>
 
 #include <math.h>
 #include <unordered_map>
@@ -44,7 +46,7 @@ namespace Simulator {
      * @param log A reference to the logging engine
      * @param globalTime The startTime of the simulation
      */
-    FCFSSchedulingPolicy::FCFSSchedulingPolicy(ArchitectureConfiguration *config, Log* log, uint64_t globalTime, bool simulateResourceUsage, int numberOfReservations, bool malleableExpand, bool malleableShrink) : SchedulingPolicy() {
+    FCFSSchedulingPolicy::FCFSSchedulingPolicy(Utils::ArchitectureConfiguration *config, Log* log, uint64_t globalTime, bool simulateResourceUsage, int numberOfReservations, bool malleableExpand, bool malleableShrink) : SchedulingPolicy() {
         this->architecture = config;
         this->log = log;
         this->globalTime = globalTime;
@@ -54,6 +56,12 @@ namespace Simulator {
         this->numberOfReservations = numberOfReservations;
         this->malleableExpand = malleableExpand;
         this->malleableShrink = malleableShrink;
+        this->lastScheduleValid = false;
+        this->lastScheduleVersion = 0;
+        this->lastScheduleTime = 0;
+        this->lastScheduleBackfilled = false;
+        this->lastNumberOfReservations = 0;
+        this->lastQueuedJob = NULL;
     }
 
     /**
@@ -92,6 +100,16 @@ namespace Simulator {
 
         //if (waitQueue.size() == 0)
         //        log->debug("In FCFS schedule", 1);
+        // The whole pass is a transaction, the jobs that get the same reservations again do not change the timelines
+        ((ResourceReservationTable*)this->reservationTable)->beginTransaction();
+
+        // Nothing the last pass depended on has changed, only the jobs that arrived since then have to be scheduled
+        if (this->canScheduleArrivalsOnly()) {
+            this->scheduleArrivalsOnly();
+            ((ResourceReservationTable*)this->reservationTable)->commitTransaction();
+            return;
+        }
+
         // First clear all previous reservatons
         for (Job* waitjob = this->waitQueue.begin(); waitjob != NULL; waitjob = this->waitQueue.next()) {
             //            cout << "DEALLOC job from WQ" << endl;
@@ -100,7 +118,7 @@ namespace Simulator {
 
         // 1. Schedule Now without and with shrink
         for (Job* job = this->waitQueue.begin(); job != NULL; job = this->waitQueue.next()) {
-            log->debug("Scheduling for job " + to_string(job->getJobNumber()) + " and is preceeded by " + to_string(job->getPrecedingJobNumber()), 1);
+            LOG_DEBUG(log, "Scheduling for job " + to_string(job->getJobNumber()) + " and is preceeded by " + to_string(job->getPrecedingJobNumber()), 1);
             //        cout << "Starting scheduling iteration" << endl;
             //        cout << "Length of wq " << this->waitQueue.size() << endl;
             //            for (Job* job = this->waitQueue.begin(); job != NULL; job = this->waitQueue.next()) {
@@ -131,12 +149,12 @@ schedstart:
             if (!allocation->getAllocationProblem()) {
                 //cout << "here\n";
                 ResourceJobAllocation *best = findBestAllocation(job, allocation);
-                if (best->getAllocations().size() == 0) std::cout << "Job number: " << job->getJobNumber() << std::endl;
+                if (best->getAllocations().size() == 0) log->error("Job number: " + to_string(job->getJobNumber()) + " has no allocations.");
                 assert(best->getAllocations().size() > 0);
                 job->setNumSimNodes(best->getAllocations().size());
                 job->setAllocatedWith(FF_AND_FCF);
                 this->allocateJob(job, best);
-                this->log->debug("The job " + to_string(job->getJobNumber()) + " will start now @ " + ftos(best->getStartTime()), 2);
+                LOG_DEBUG(this->log, "The job " + to_string(job->getJobNumber()) + " will start now @ " + ftos(best->getStartTime()), 2);
                 // create start event
                 this->sim->simInsertJobStartEvent(job);
                 // create finish event
@@ -176,50 +194,9 @@ schedstart:
         std::vector<Job*> tmpJobvec;
 
         // 3. Backfill
-        i = 0;
         if (this->numberOfReservations != -1) {
-            for (Job* job = this->waitQueue.begin(); job != NULL; job = this->waitQueue.next()) {
-                //cout << "Trying to backfill job " << job->getJobNumber() << endl;
-                ResourceJobAllocation* allocation = ((ResourceReservationTable*)this->reservationTable)->findPossibleAllocation(job, globalTime, job->getRequestedTime());
-                if (!allocation->getAllocationProblem()) {
-                    // the allocation is now
-                    ResourceJobAllocation *best = findBestAllocation(job, allocation);
-                    assert(best->getAllocations().size() > 0);
-                    job->setAllocatedWith(FF_AND_FCF);
-                    this->allocateJob(job, best);
-                    this->log->debug("The job " + to_string(job->getJobNumber()) + " will start now @ " + ftos(allocation->getStartTime()), 2);
-                    // create start event
-                    this->sim->simInsertJobStartEvent(job);
-                    // create finish event
-                    this->sim->simInsertJobFinishEvent(job);
-                    //cout << "job " << job->getJobNumber() << " is being backfilled" << endl;
-                    //job->setJobSimssBackfilled(job);
-                    this->sim->backfillcounter++;
-                    tmpJobvec.push_back(job);
-                } else {
-                    if ((this->numberOfReservations != 0) && (numberOfReservationsCur == this->numberOfReservations)) {
-                        delete allocation;
-                        continue;
-                    }
-                    // find a later allocation and reserve it
-                    delete allocation;
-                    ResourceJobAllocation* allocation = findAllocation(job, globalTime, job->getRequestedTime());
-                    assert(allocation->getAllocations().size() > 0);
-                    assert(allocation->getStartTime() != globalTime);
-                    if (!allocation->getAllocationProblem()) {
-                        ResourceJobAllocation* best = findBestAllocation(job, allocation);
-                        assert(best->getAllocations().size() > 0);
-                        job->setAllocatedWith(FF_AND_FCF);
-                        this->allocateJob(job, best);
-                        this->log->debug("The job " + to_string(job->getJobNumber()) + " can start at " + ftos(allocation->getStartTime()), 2);
-                        numberOfReservationsCur++;
-                        //cout << "job " << job->getJobNumber() << " reserved for future" << endl;
-                    } else {
-                        delete allocation;
-                    }
-                    i++;
-                }
-            }
+            for (Job* job = this->waitQueue.begin(); job != NULL; job = this->waitQueue.next())
+                this->backfillJob(job, numberOfReservationsCur, tmpJobvec);
         }
 
         for (std::vector<Job*>::iterator it = tmpJobvec.begin(); it != tmpJobvec.end(); ++it) {
@@ -235,6 +212,117 @@ schedstart:
 
         // Clear startNowQueue
         this->startNowQueue.clear();
+
+        ((ResourceReservationTable*)this->reservationTable)->commitTransaction();
+        this->rememberSchedule(numberOfReservationsCur, not tmpJobvec.empty());
+    }
+
+    /**
+     * Tries to backfill a job of the wait queue: the job starts now if it fits, otherwise it gets a reservation
+     * in the future while the number of reservations allows it.
+     * @param job The job to backfill
+     * @param numberOfReservationsCur The number of reservations done in the current pass, it is updated
+     * @param started The jobs that start now, the job is added at the end if it starts
+     */
+    void FCFSSchedulingPolicy::backfillJob(Job* job, int& numberOfReservationsCur, std::vector<Job*>& started) {
+        //cout << "Trying to backfill job " << job->getJobNumber() << endl;
+        ResourceJobAllocation* allocation = ((ResourceReservationTable*)this->reservationTable)->findPossibleAllocation(job, globalTime, job->getRequestedTime());
+        if (!allocation->getAllocationProblem()) {
+            // the allocation is now
+            ResourceJobAllocation *best = findBestAllocation(job, allocation);
+            assert(best->getAllocations().size() > 0);
+            job->setAllocatedWith(FF_AND_FCF);
+            this->allocateJob(job, best);
+            LOG_DEBUG(this->log, "The job " + to_string(job->getJobNumber()) + " will start now @ " + ftos(allocation->getStartTime()), 2);
+            // create start event
+            this->sim->simInsertJobStartEvent(job);
+            // create finish event
+            this->sim->simInsertJobFinishEvent(job);
+            //cout << "job " << job->getJobNumber() << " is being backfilled" << endl;
+            //job->setJobSimssBackfilled(job);
+            this->sim->backfillcounter++;
+            started.push_back(job);
+        } else {
+            if ((this->numberOfReservations != 0) && (numberOfReservationsCur == this->numberOfReservations)) {
+                delete allocation;
+                return;
+            }
+            // find a later allocation and reserve it
+            delete allocation;
+            ResourceJobAllocation* allocation = findAllocation(job, globalTime, job->getRequestedTime());
+            assert(allocation->getCandidates().size() > 0);
+            assert(allocation->getStartTime() != globalTime);
+            if (!allocation->getAllocationProblem()) {
+                ResourceJobAllocation* best = findBestAllocation(job, allocation);
+                assert(best->getAllocations().size() > 0);
+                job->setAllocatedWith(FF_AND_FCF);
+                this->allocateJob(job, best);
+                LOG_DEBUG(this->log, "The job " + to_string(job->getJobNumber()) + " can start at " + ftos(allocation->getStartTime()), 2);
+                numberOfReservationsCur++;
+                //cout << "job " << job->getJobNumber() << " reserved for future" << endl;
+            } else {
+                delete allocation;
+            }
+        }
+    }
+
+    /**
+     * Returns if the last pass is still the one a full pass would do now, apart from the jobs that arrived after it.
+     * It is the case when the view of the table has not changed since then, the last pass did not backfill any job,
+     * which would change what the jobs before it see, and the pass happens at the same time. Without backfill
+     * reservations the head of the queue is the only job that matters, and as the free resources of a table that
+     * has not changed can only grow along the time only a job finish, which changes the table, can start it.
+     * Any finish or early termination changes the table, so the pass after it goes over the whole queue.
+     * @return True if only the jobs that arrived after the last pass have to be scheduled
+     */
+    bool FCFSSchedulingPolicy::canScheduleArrivalsOnly() {
+        if (not this->architecture->getSystemOrchestrator()->getsimuConfig()->scheduleArrivalsOnly)
+            return false;
+        if (not this->lastScheduleValid or this->lastQueuedJob == NULL)
+            return false;
+        if (this->malleableExpand or this->malleableShrink or this->lastScheduleBackfilled)
+            return false;
+        if (this->numberOfReservations != -1 and this->globalTime != this->lastScheduleTime)
+            return false;
+        return ((ResourceReservationTable*)this->reservationTable)->getVersion() == this->lastScheduleVersion;
+    }
+
+    /**
+     * Schedules the jobs that arrived after the last pass. The head of the queue could not start then and it cannot
+     * start now, so the new jobs can only be backfilled behind it, after the reservations of the last pass.
+     */
+    void FCFSSchedulingPolicy::scheduleArrivalsOnly() {
+        int numberOfReservationsCur = this->lastNumberOfReservations;
+        std::vector<Job*> tmpJobvec;
+
+        LOG_DEBUG(this->log, "Scheduling the arrivals after the job " + to_string(this->lastQueuedJob->getJobNumber()), 2);
+        if (this->numberOfReservations != -1) {
+            FCFSQueue* queue = this->waitQueue.getQueue();
+            for (FCFSQueue::iterator it = queue->upper_bound(this->lastQueuedJob); it != queue->end(); ++it)
+                this->backfillJob(*it, numberOfReservationsCur, tmpJobvec);
+        }
+
+        for (std::vector<Job*>::iterator it = tmpJobvec.begin(); it != tmpJobvec.end(); ++it) {
+            reservedQueue.insert(*it);
+            waitQueue.erase(*it);
+        }
+        this->startNowQueue.clear();
+        this->rememberSchedule(numberOfReservationsCur, not tmpJobvec.empty());
+    }
+
+    /**
+     * Keeps what the next pass needs to go on from where this one left the queue and the reservation table
+     * @param numberOfReservationsCur The number of reservations done in the pass
+     * @param backfilled True if some job was backfilled to start now
+     */
+    void FCFSSchedulingPolicy::rememberSchedule(int numberOfReservationsCur, bool backfilled) {
+        FCFSQueue* queue = this->waitQueue.getQueue();
+        this->lastScheduleValid = true;
+        this->lastScheduleVersion = ((ResourceReservationTable*)this->reservationTable)->getVersion();
+        this->lastScheduleTime = this->globalTime;
+        this->lastScheduleBackfilled = backfilled;
+        this->lastNumberOfReservations = numberOfReservationsCur;
+        this->lastQueuedJob = queue->empty() ? NULL : *queue->rbegin();
     }
 
     void FCFSSchedulingPolicy::Reschedule() {
@@ -242,14 +330,14 @@ schedstart:
             double startTime = (lastAllowedStartTime < globalTime) ? globalTime : lastAllowedStartTime; //we will try to allocate the job from now
             assert(startTime >= 0);
             ResourceJobAllocation* allocation = findAllocation(job, startTime, job->getRunTime());
-            assert(allocation->getAllocations().size() > 0);
+            assert(allocation->getCandidates().size() > 0);
             if (!allocation->getAllocationProblem()) {
                 ResourceJobAllocation *best = findBestAllocation(job, allocation);
                 assert(best->getAllocations().size() > 0);
                 //TODO: Consider different RS_policy_type used.
                 job->setAllocatedWith(FF_AND_FCF);
                 this->allocateJob(job, best);
-                this->log->debug("The job " + to_string(job->getJobNumber()) + " can start at " + ftos(allocation->getStartTime()), 2);
+                LOG_DEBUG(this->log, "The job " + to_string(job->getJobNumber()) + " can start at " + ftos(allocation->getStartTime()), 2);
 
                 //we update the last allowed start time to the start time of this job
                 this->lastAllowedStartTime = allocation->getStartTime();
@@ -260,6 +348,8 @@ schedstart:
     }
 
     void FCFSSchedulingPolicy::jobAddToWaitQueue(Job * job) {
+        if (this->lastQueuedJob != NULL and not arrivaltime_lt_t()(this->lastQueuedJob, job))
+            this->lastScheduleValid = false;
         this->waitQueue.insert(job);
         if (waitQueue.size() == 1)
             schedule();
@@ -275,6 +365,10 @@ schedstart:
         //first we call to the upper class that will make some arrangements in the jobs, like updated the job run time  according the jobruntime factor
         SchedulingPolicy::jobArrive(job);
 
+        // A job that does not go to the end of the queue changes what the jobs after it see
+        if (this->lastQueuedJob != NULL and not arrivaltime_lt_t()(this->lastQueuedJob, job))
+            this->lastScheduleValid = false;
+
         //otherwise to the queue
         this->waitQueue.insert(job);
 
@@ -286,7 +380,7 @@ schedstart:
         ResourceJobAllocation* allocation = findAllocation(job, startTime, job->getRunTime());
         printf("still executed\n");
 
-        assert(allocation->getAllocations().size() > 0);
+        assert(allocation->getCandidates().size() > 0);
         /* should not be any problem */
         if (!allocation->getAllocationProblem()) {
             ResourceJobAllocation *best = findBestAllocation(job, allocation);
@@ -294,7 +388,7 @@ schedstart:
             //TODO: Consider different RS_policy_type used.
             job->setAllocatedWith(FF_AND_FCF);
             this->allocateJob(job, best);
-            this->log->debug("The job " + to_string(job->getJobNumber()) + " can start at " + ftos(allocation->getStartTime()), 2);
+            LOG_DEBUG(this->log, "The job " + to_string(job->getJobNumber()) + " can start at " + ftos(allocation->getStartTime()), 2);
 
             //we update the last allowed start time to the start time of this job
             this->lastAllowedStartTime = allocation->getStartTime();
@@ -331,7 +425,7 @@ schedstart:
             .diskBW = 0.0, .memBW = 0.0, .fabBW = 0.0
         };
 
-        std::deque<ResourceBucket*> allocations = alloc->getAllocations();
+        const std::vector<AvailabilityWindow>& candidates = alloc->getCandidates();
 
         ResourceJobAllocation *best = new ResourceJobAllocation();
         best->setStartTime(alloc->getStartTime());
@@ -339,20 +433,20 @@ schedstart:
 
         std::deque<ResourceBucket*> bestBuckets;
 
-        for (uint32_t i = 0; i < allocations.size(); i++) {
+        for (uint32_t i = 0; i < candidates.size(); i++) {
 
             ReservationList rl = {0};
             bool reserve = false;
             uint32_t neededcpus = rr.cpus - avail.cpus;
 
-            if ((rr.cpusPerNode > allocations[i]->getFreeCPUs()) or
-                    (rr.memPerNode > allocations[i]->getFreeMemory()) or
-                    (rr.diskPerNode > allocations[i]->getFreeDisk())) continue;
+            if ((rr.cpusPerNode > candidates[i].freeCPUs) or
+                    (rr.memPerNode > candidates[i].freeMemory) or
+                    (rr.diskPerNode > candidates[i].freeDisk)) continue;
             if (neededcpus > 0) {
                 uint64_t memPerCore = job->getRequestedMemory();
-                uint32_t maxcpus = (rr.mem == 0) ? rr.cpus : allocations[i]->getFreeMemory() / memPerCore;
+                uint32_t maxcpus = (rr.mem == 0) ? rr.cpus : candidates[i].freeMemory / memPerCore;
                 //Memory is specified by processor. Therefore, free memory could limit the number of processors to reserve.
-                maxcpus = (maxcpus < allocations[i]->getFreeCPUs()) ? maxcpus : allocations[i]->getFreeCPUs();
+                maxcpus = (maxcpus < candidates[i].freeCPUs) ? maxcpus : candidates[i].freeCPUs;
 
                 uint32_t reserveCPUs = (neededcpus > maxcpus) ? maxcpus : neededcpus;
                 avail.cpus += reserveCPUs;
@@ -363,7 +457,7 @@ schedstart:
             }
 
             if (avail.disk < rr.disk) {
-                uint64_t freedisk = allocations[i]->getFreeDisk();
+                uint64_t freedisk = candidates[i].freeDisk;
                 rl.disk = (rr.disk > freedisk) ? freedisk : rr.disk;
                 avail.disk += rl.disk;
 
@@ -371,8 +465,8 @@ schedstart:
             }
 
             if (reserve) {
-                ResourceBucket *rb = new ResourceBucket(rl, allocations[i]->getStartTime(), allocations[i]->getEndTime());
-                rb->setID(allocations[i]->getID());
+                ResourceBucket *rb = new ResourceBucket(rl, candidates[i].startTime, candidates[i].endTime);
+                rb->setID(candidates[i].id);
                 bestBuckets.push_back(rb);
             }
 
@@ -409,7 +503,7 @@ schedstart:
             .diskBW = 0.0, .memBW = 0.0, .fabBW = 0.0
         };
 
-        std::deque<ResourceBucket*> allocations = alloc->getAllocations();
+        const std::vector<AvailabilityWindow>& candidates = alloc->getCandidates();
 
         ResourceJobAllocation *best = new ResourceJobAllocation();
         best->setStartTime(alloc->getStartTime());
@@ -417,20 +511,20 @@ schedstart:
 
         std::deque<ResourceBucket*> bestBuckets;
 
-        for (uint32_t i = 0; i < allocations.size(); i++) {
+        for (uint32_t i = 0; i < candidates.size(); i++) {
 
             ReservationList rl = {0};
             bool reserve = false;
             uint32_t neededcpus = rr.cpus - avail.cpus;
-            if ((rr.cpusPerNode > allocations[i]->getFreeCPUs()) or
-                    (rr.memPerNode > allocations[i]->getFreeMemory()) or
-                    (rr.diskPerNode > allocations[i]->getFreeDisk())) continue;
+            if ((rr.cpusPerNode > candidates[i].freeCPUs) or
+                    (rr.memPerNode > candidates[i].freeMemory) or
+                    (rr.diskPerNode > candidates[i].freeDisk)) continue;
 
             if (neededcpus > 0) {
 
-                uint32_t maxcpus = (rr.mem == 0) ? rr.cpus : allocations[i]->getFreeMemory() / rr.mem;
+                uint32_t maxcpus = (rr.mem == 0) ? rr.cpus : candidates[i].freeMemory / rr.mem;
                 //Memory is specified by processor. Therefore, free memory could limit the number of processors to reserve.
-                maxcpus = (maxcpus < allocations[i]->getFreeCPUs()) ? maxcpus : allocations[i]->getFreeCPUs();
+                maxcpus = (maxcpus < candidates[i].freeCPUs) ? maxcpus : candidates[i].freeCPUs;
 
                 uint32_t reserveCPUs = (neededcpus > maxcpus) ? maxcpus : neededcpus;
                 avail.cpus += reserveCPUs;
@@ -441,7 +535,7 @@ schedstart:
             }
 
             if (avail.disk < rr.disk) {
-                uint64_t freedisk = allocations[i]->getFreeDisk();
+                uint64_t freedisk = candidates[i].freeDisk;
                 rl.disk = (rr.disk > freedisk) ? freedisk : rr.disk;
                 avail.disk += rl.disk;
 
@@ -449,8 +543,8 @@ schedstart:
             }
 
             if (reserve) {
-                ResourceBucket *rb = new ResourceBucket(rl, allocations[i]->getStartTime(), allocations[i]->getEndTime());
-                rb->setID(allocations[i]->getID());
+                ResourceBucket *rb = new ResourceBucket(rl, candidates[i].startTime, candidates[i].endTime);
+                rb->setID(candidates[i].id);
                 bestBuckets.push_back(rb);
             }
 
@@ -470,7 +564,7 @@ schedstart:
 
     void FCFSSchedulingPolicy::jobFinish(Job * job) {
 
-        log->debug("Finishing Job " + to_string(job->getJobNumber()) + " at globalTime: " + to_string((unsigned int) globalTime), 1);
+        LOG_DEBUG(log, "Finishing Job " + to_string(job->getJobNumber()) + " at globalTime: " + to_string((unsigned int) globalTime), 1);
 
         //We call to the base class - important it has to update some info
         SchedulingPolicy::jobFinish(job);
@@ -589,6 +683,8 @@ schedstart:
         this->runningQueue.insert(job);
         //cout << "Starting job " << job->getJobNumber() << " and finiqueue size = " << this->realFiniQueue.size() << endl;
         /* as this is a FCFS policy the job is allocated definitively in the queue, so we can delete it from the wait queue */
+        if (this->waitQueue.contains(job))
+            this->lastScheduleValid = false;
         this->waitQueue.erase(job);
         this->reservedQueue.erase(job);
         //cout << "Wait queue size after starting job " << job->getJobNumber() << " is " << this->waitQueue.size() << endl;
@@ -614,7 +710,7 @@ schedstart:
         //            this->prvTrace->ParaverJobRuns(job->getJobNumber(), allocs);
         //        }
         if (this->outputTrace) {
-            log->debug("Pushing " + to_string(allocs.size()) + " buckets to output Trace handler.", 4);
+            LOG_DEBUG(log, "Pushing " + to_string(allocs.size()) + " buckets to output Trace handler.", 4);
             this->opTrace->jobStart(job->getJobNumber(), allocs, false);
         }
         //cout << "Starting Job " << job->getJobNumber() << " at globalTime: " << (unsigned int)globalTime << endl;
@@ -675,7 +771,7 @@ schedstart:
         //since the allocation won't be used any more we delete it
         delete allocation;
 
-        log->debug("The job " + to_string(job->getJobNumber()) + " would start at " + ftos(wouldStart) + " and arrives at " + ftos(globalTime) + " in the FCFS", 2);
+        LOG_DEBUG(log, "The job " + to_string(job->getJobNumber()) + " would start at " + ftos(wouldStart) + " and arrives at " + ftos(globalTime) + " in the FCFS", 2);
 
         switch (MetricType) {
             case SLD:
@@ -840,6 +936,8 @@ malfind:
         bool allocated = false;
 
         while (!allocated) {
+            //the nodes are only explored once the whole system has enough free resources for the job
+            startTime = ((ResourceReservationTable*)this->reservationTable)->findEarliestStart(job, startTime, runtime);
             ResourceJobAllocation* possibleAllocation =
                     ((ResourceReservationTable*)this->reservationTable)->findPossibleAllocation(job, startTime, runtime);
 
@@ -853,7 +951,7 @@ malfind:
                  ** We now need to find an actual allocation according to the scheduling policy. */
                 bool useFirstFit = this->getRS_policyUsed() == FIRST_FIT or this->getRS_policyUsed() == FF_AND_FCF;
                 if (not useFirstFit) {
-                    std::cout << "RS policy Used: " << this->getRS_policyUsed() << std::endl;
+                    log->error("RS policy Used: " + to_string(this->getRS_policyUsed()));
                 }
                 assert(useFirstFit);
 
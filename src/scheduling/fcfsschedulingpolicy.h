@@ -79,6 +79,10 @@ namespace Simulator
         ResourceJobAllocation* findBestAllocation(Job *job, ResourceJobAllocation* alloc);
         ResourceJobAllocation* findBestExtraAllocation(Job *job, ResourceJobAllocation* alloc);
         ResourceJobAllocation* findAllocation(Job* job, double startTime, double runtime);
+        void backfillJob(Job* job, int& numberOfReservationsCur, std::vector<Job*>& started);
+        bool canScheduleArrivalsOnly();
+        void scheduleArrivalsOnly();
+        void rememberSchedule(int numberOfReservationsCur, bool backfilled);
         
         FCFSJobQueue waitQueue; /**< The wait queue job list*/
         RealFinishJobQueue realFiniQueue; /**< The runing and finished queue job list ordered by real finish time*/
@@ -92,6 +96,13 @@ namespace Simulator
         int malleableExpand; /**< If malleable expand should be enabled */
         int malleableShrink; /**< If malleable shrink should be enabled */
 
+        bool lastScheduleValid; /**< Indicates if the last pass can be continued by one that only schedules the new arrivals */
+        uint64_t lastScheduleVersion; /**< The version of the reservation table left by the last pass */
+        uint64_t lastScheduleTime; /**< The time of the last pass */
+        bool lastScheduleBackfilled; /**< Indicates if the last pass backfilled some job to start now */
+        int lastNumberOfReservations; /**< The number of backfill reservations done by the last pass */
+        Job* lastQueuedJob; /**< The last job of the wait queue after the last pass, NULL if it was empty */
+
     };
 
 }
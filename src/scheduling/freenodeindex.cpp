@@ -0,0 +1,221 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/freenodeindex.h>
+
+#include <algorithm>
+#include <assert.h>
+
+namespace Simulator {
+
+    /** Order used to look for the step that contains a given time. */
+    struct StepStartTime_lt_t {
+
+        bool operator()(double time, const FreeNodeStep& step) const {
+            return time < step.startTime;
+        }
+    };
+
+    /**
+     * The constructor for the class. The index starts with a single step and without nodes.
+     * @param startTime The first time of the index
+     */
+    FreeNodeIndex::FreeNodeIndex(double startTime) {
+        this->numberOfNodes = 0;
+
+        FreeNodeStep first;
+        first.startTime = startTime;
+        this->steps.push_back(first);
+    }
+
+    /**
+     * The default destructor for the class
+     */
+    FreeNodeIndex::~FreeNodeIndex() {
+    }
+
+    /**
+     * Adds a node to the index, it is free along the whole time
+     */
+    void FreeNodeIndex::addNode() {
+        uint32_t node = this->numberOfNodes++;
+        for (vector<FreeNodeStep>::iterator it = this->steps.begin(); it != this->steps.end(); ++it) {
+            it->freeNodes.resize((this->numberOfNodes + 63) / 64, 0);
+            it->freeNodes[node / 64] |= (uint64_t) 1 << (node % 64);
+        }
+    }
+
+    /**
+     * Updates the bit of a node between startTime and endTime from its timeline, after a reservation or a release.
+     * The steps are broken down at every change of the node, and the ones that end up with the same bitset are joined.
+     * @param node The node
+     * @param startTime The first time that has changed
+     * @param endTime The last time that has changed
+     * @param nodeTimeline The timeline of the node, already changed
+     * @param cpus The number of cpus of the node
+     */
+    void FreeNodeIndex::update(uint32_t node, double startTime, double endTime, const NodeTimeline& nodeTimeline, uint32_t cpus) {
+        assert(node < this->numberOfNodes and startTime <= endTime);
+        const vector<TimelineSegment>& segments = nodeTimeline.getSegments();
+
+        //the past of the node or of the index may have been trimmed
+        if (startTime < segments.front().startTime)
+            startTime = segments.front().startTime;
+        if (startTime < this->steps.front().startTime)
+            startTime = this->steps.front().startTime;
+        if (endTime < startTime)
+            return;
+
+        size_t first = this->split(startTime);
+        size_t segment = nodeTimeline.findSegment(startTime);
+        for (size_t next = segment + 1; next < segments.size() and segments[next].startTime <= endTime; next++)
+            this->split(segments[next].startTime);
+        size_t last = this->split(endTime + 1);
+
+        uint64_t mask = (uint64_t) 1 << (node % 64);
+        for (size_t pos = first; pos < last; pos++) {
+            FreeNodeStep& step = this->steps[pos];
+            while (segment + 1 < segments.size() and segments[segment + 1].startTime <= step.startTime)
+                segment++;
+
+            if (segments[segment].freeCPUs == cpus)
+                step.freeNodes[node / 64] |= mask;
+            else
+                step.freeNodes[node / 64] &= ~mask;
+        }
+
+        //join the steps of the range, and the one that follows it, with the previous one if nothing changes between them
+        size_t end = (last < this->steps.size()) ? last : this->steps.size() - 1;
+        size_t kept = (first > 0) ? first - 1 : 0;
+        for (size_t pos = kept + 1; pos <= end; pos++) {
+            if (this->steps[pos].freeNodes != this->steps[kept].freeNodes) {
+                kept++;
+                if (kept != pos)
+                    std::swap(this->steps[kept], this->steps[pos]);
+            }
+        }
+        this->steps.erase(this->steps.begin() + kept + 1, this->steps.begin() + end + 1);
+    }
+
+    /**
+     * Returns the nodes that are completely free along a whole window, from time to time plus length
+     * @param time The start of the window
+     * @param length The length of the window
+     * @param freeNodes Returns the bitset of the free nodes
+     */
+    void FreeNodeIndex::findFreeNodes(double time, double length, vector<uint64_t>& freeNodes) const {
+        size_t pos = this->findStep(time);
+        freeNodes = this->steps[pos].freeNodes;
+
+        for (pos++; pos < this->steps.size() and this->steps[pos].startTime <= time + length; pos++) {
+            const vector<uint64_t>& stepNodes = this->steps[pos].freeNodes;
+            for (size_t word = 0; word < freeNodes.size(); word++)
+                freeNodes[word] &= stepNodes[word];
+        }
+    }
+
+    /**
+     * Returns the start of the first step after time where some node becomes completely free. Until then the
+     * free nodes can only decrease, so no window starting before can have more free nodes than the one starting at time.
+     * @param time The time to look from
+     * @return The time of the next release, -1 if there is none
+     */
+    double FreeNodeIndex::findNextRelease(double time) const {
+        return this->findNextRelease(time, 0, this->numberOfNodes);
+    }
+
+    /**
+     * Same as findNextRelease, but only the releases of the nodes in a range are taken into account
+     * @param time The time to look from
+     * @param firstNode The first node of the range
+     * @param numberOfNodes The number of nodes of the range
+     * @return The time of the next release of a node of the range, -1 if there is none
+     */
+    double FreeNodeIndex::findNextRelease(double time, uint32_t firstNode, uint32_t numberOfNodes) const {
+        assert(firstNode + numberOfNodes <= this->numberOfNodes);
+        if (numberOfNodes == 0)
+            return -1;
+        uint32_t lastNode = firstNode + numberOfNodes - 1;
+
+        for (size_t pos = this->findStep(time) + 1; pos < this->steps.size(); pos++) {
+            const vector<uint64_t>& previous = this->steps[pos - 1].freeNodes;
+            const vector<uint64_t>& current = this->steps[pos].freeNodes;
+            for (size_t word = firstNode / 64; word <= lastNode / 64; word++) {
+                uint64_t mask = ~(uint64_t) 0;
+                if (word == firstNode / 64)
+                    mask &= ~(uint64_t) 0 << (firstNode % 64);
+                if (word == lastNode / 64 and lastNode % 64 != 63)
+                    mask &= ((uint64_t) 1 << (lastNode % 64 + 1)) - 1;
+                if (current[word] & ~previous[word] & mask)
+                    return this->steps[pos].startTime;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Removes the steps that are before time, the step that contains time begins at it afterwards.
+     * @param time The time before which the steps are not needed anymore
+     */
+    void FreeNodeIndex::trim(double time) {
+        size_t pos = this->findStep(time);
+        if (this->steps[pos].startTime < time)
+            this->steps[pos].startTime = time;
+        this->steps.erase(this->steps.begin(), this->steps.begin() + pos);
+    }
+
+    /**
+     * Returns the number of steps of the index
+     * @return The number of steps
+     */
+    size_t FreeNodeIndex::getNumberOfSteps() const {
+        return this->steps.size();
+    }
+
+    /**
+     * Returns the position of the step that contains a given time (the last one that starts before or at time).
+     * @param time The time to look for, the first step is used for the times before the index
+     * @return The position of the step
+     */
+    size_t FreeNodeIndex::findStep(double time) const {
+        vector<FreeNodeStep>::const_iterator it = std::upper_bound(this->steps.begin(), this->steps.end(), time, StepStartTime_lt_t());
+        if (it == this->steps.begin())
+            return 0;
+        return (it - this->steps.begin()) - 1;
+    }
+
+    /**
+     * Makes sure that a step starts at time, the step that contains it is broken down otherwise.
+     * @param time The time where a step has to start
+     * @return The position of the step that starts at time
+     */
+    size_t FreeNodeIndex::split(double time) {
+        size_t pos = this->findStep(time);
+        if (this->steps[pos].startTime >= time)
+            return pos;
+
+        FreeNodeStep newStep;
+        newStep.startTime = time;
+        newStep.freeNodes = this->steps[pos].freeNodes;
+        this->steps.insert(this->steps.begin() + pos + 1, newStep);
+        return pos + 1;
+    }
+
+}
@@ -0,0 +1,72 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATORFREENODEINDEX_H
+#define SIMULATORFREENODEINDEX_H
+
+#include <scheduling/nodetimeline.h>
+#include <stdint.h>
+#include <vector>
+
+using std::vector;
+
+namespace Simulator {
+
+    /** An interval of time where every node is either completely free or not. */
+    struct FreeNodeStep {
+        double startTime; /**< The first time of the step, it lasts until the start of the next one */
+        vector<uint64_t> freeNodes; /**< Bit n is set if all the cpus of the node n are free along the whole step */
+    };
+
+    /**
+     * The nodes that are completely free along the time, as a bitset per step. It is used when the jobs reserve full
+     * nodes: the nodes that are free during a whole window are the AND of the bitsets of the steps it overlaps,
+     * so the busy nodes are discarded without walking their timelines. The steps are kept sorted by start time in a
+     * contiguous vector, the neighbour steps with the same bitset are joined. The steps of the past can be trimmed.
+     */
+    class FreeNodeIndex {
+    public:
+        FreeNodeIndex(double startTime);
+        ~FreeNodeIndex();
+
+        void addNode();
+        void update(uint32_t node, double startTime, double endTime, const NodeTimeline& nodeTimeline, uint32_t cpus);
+        void findFreeNodes(double time, double length, vector<uint64_t>& freeNodes) const;
+        double findNextRelease(double time) const;
+        double findNextRelease(double time, uint32_t firstNode, uint32_t numberOfNodes) const;
+        void trim(double time);
+        size_t getNumberOfSteps() const;
+
+        /** Returns true if the bit of the node is set in the bitset. */
+        static bool isFree(const vector<uint64_t>& freeNodes, uint32_t node) {
+            return (freeNodes[node / 64] >> (node % 64)) & 1;
+        }
+
+    private:
+        size_t findStep(double time) const;
+        size_t split(double time);
+
+        uint32_t numberOfNodes; /**< The number of nodes of the bitsets */
+        vector<FreeNodeStep> steps; /**< The steps, sorted by startTime */
+    };
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/heapeventqueue.h>
+
+#include <algorithm>
+
+namespace Simulator {
+
+    /**
+     * The default constructor for the class
+     */
+    HeapEventQueue::HeapEventQueue() {
+    }
+
+    /**
+     * The default destructor for the class. The events are owned by the simulation, they are not deleted here.
+     */
+    HeapEventQueue::~HeapEventQueue() {
+    }
+
+    /**
+     * Inserts a new event in the queue
+     * @param event The event to be inserted, it must not be already queued
+     */
+    void HeapEventQueue::insert(SimulationEvent* event) {
+        assert(event->getQueuePosition() == -1);
+        this->heap.push_back(event);
+        this->place(event, this->heap.size() - 1);
+        this->siftUp(this->heap.size() - 1);
+    }
+
+    /**
+     * Removes an event from the queue. The event is not deleted.
+     * @param event The event to be removed, it must be queued
+     */
+    void HeapEventQueue::erase(SimulationEvent* event) {
+        assert(this->contains(event));
+        size_t pos = event->getQueuePosition();
+        SimulationEvent* last = this->heap.back();
+        this->heap.pop_back();
+        event->setQueuePosition(-1);
+        if (last == event)
+            return;
+        this->place(last, pos);
+        this->update(pos);
+    }
+
+    /**
+     * Restores the heap order around the event stored in pos, that has been moved there from the end of the heap.
+     * @param pos The slot of the heap
+     */
+    void HeapEventQueue::update(size_t pos) {
+        if (pos > 0 && this->before(this->heap[pos], this->heap[(pos - 1) / EVENT_QUEUE_ARITY]))
+            this->siftUp(pos);
+        else
+            this->siftDown(pos);
+    }
+
+    /**
+     * Returns the event at the head of the queue
+     * @return The next event to be treated, NULL if the queue is empty
+     */
+    SimulationEvent* HeapEventQueue::top() const {
+        if (this->heap.empty())
+            return NULL;
+        return this->heap[0];
+    }
+
+    /**
+     * Indicates if the event is stored in this queue
+     * @param event The event to check
+     * @return True if the event is queued
+     */
+    bool HeapEventQueue::contains(SimulationEvent* event) const {
+        int pos = event->getQueuePosition();
+        return pos >= 0 && (size_t) pos < this->heap.size() && this->heap[pos] == event;
+    }
+
+    /**
+     * Returns the number of pending events
+     * @return The size of the queue
+     */
+    size_t HeapEventQueue::size() const {
+        return this->heap.size();
+    }
+
+    /**
+     * Appends the pending events, in no particular order, to the given vector
+     * @param events The vector where the events are stored
+     */
+    void HeapEventQueue::getEvents(vector<SimulationEvent*>& events) const {
+        events.insert(events.end(), this->heap.begin(), this->heap.end());
+    }
+
+    /**
+     * Stores the event in the given slot of the heap
+     * @param event The event to store
+     * @param pos The slot of the heap
+     */
+    void HeapEventQueue::place(SimulationEvent* event, size_t pos) {
+        this->heap[pos] = event;
+        event->setQueuePosition(pos);
+    }
+
+    /**
+     * Moves the event stored in pos towards the head of the queue until its parent goes before it
+     * @param pos The slot of the heap to start from
+     */
+    void HeapEventQueue::siftUp(size_t pos) {
+        SimulationEvent* event = this->heap[pos];
+        while (pos > 0) {
+            size_t parent = (pos - 1) / EVENT_QUEUE_ARITY;
+            if (!this->before(event, this->heap[parent]))
+                break;
+            this->place(this->heap[parent], pos);
+            pos = parent;
+        }
+        this->place(event, pos);
+    }
+
+    /**
+     * Moves the event stored in pos towards the leaves until all its children go after it
+     * @param pos The slot of the heap to start from
+     */
+    void HeapEventQueue::siftDown(size_t pos) {
+        SimulationEvent* event = this->heap[pos];
+        size_t size = this->heap.size();
+        while (true) {
+            size_t first = pos * EVENT_QUEUE_ARITY + 1;
+            if (first >= size)
+                break;
+            size_t last = min(first + EVENT_QUEUE_ARITY, size);
+            size_t best = first;
+            for (size_t child = first + 1; child < last; child++) {
+                if (this->before(this->heap[child], this->heap[best]))
+                    best = child;
+            }
+            if (!this->before(this->heap[best], event))
+                break;
+            this->place(this->heap[best], pos);
+            pos = best;
+        }
+        this->place(event, pos);
+    }
+
+}
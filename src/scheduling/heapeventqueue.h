@@ -0,0 +1,58 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATORHEAPEVENTQUEUE_H
+#define SIMULATORHEAPEVENTQUEUE_H
+
+/** Number of children of each node of the event heap */
+#define EVENT_QUEUE_ARITY 4
+
+#include <scheduling/eventqueue.h>
+
+namespace Simulator {
+
+    /**
+     * Event queue implemented as an indexed d-ary heap ordered with eventorder_t. Each queued event knows its slot in the heap
+     * so it can be removed in O(log n) without searching for it.
+     */
+    class HeapEventQueue : public EventQueue {
+    public:
+        HeapEventQueue();
+        ~HeapEventQueue();
+
+        void insert(SimulationEvent* event) override;
+        void erase(SimulationEvent* event) override;
+        SimulationEvent* top() const override;
+        bool contains(SimulationEvent* event) const override;
+        size_t size() const override;
+        void getEvents(vector<SimulationEvent*>& events) const override;
+
+    private:
+        void place(SimulationEvent* event, size_t pos);
+        void update(size_t pos);
+        void siftUp(size_t pos);
+        void siftDown(size_t pos);
+
+        vector<SimulationEvent*> heap; /**< The heap of pending events, the head of the queue is at position 0 */
+    };
+
+}
+
+#endif
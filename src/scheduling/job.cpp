@@ -101,12 +101,15 @@ namespace Simulator {
         maxNumberOfProcessors = 0;
         
         slurmprio = 1000; // SLURM starts things at 1000, so do we.
+        slurmEligibleTime = 0;
+        slurmFactors = 0;
         
         nmetric_delaysec = 0.0;
         nmetric_archerratio = -1;
         
         workflow_id = 0;
         workflow_status = 0;
+        unmet_predecessors = 0;
 
     }
 
@@ -121,6 +124,21 @@ namespace Simulator {
         jobPenalties.clear();
     }
 
+    /**
+     * Returns a copy of the job for another simulation of the same workload. The copy has its own penalized times, the
+     * workflow links and the event handles are not copied, the links have to be resolved again among the copied jobs.
+     * @return The copy of the job
+     */
+    Job* Job::clone() const {
+        Job* copy = new Job(*this);
+        for (jobMapBucketPenalizedTimes_t::iterator it = copy->jobPenalties.begin(); it != copy->jobPenalties.end(); it++)
+            it->second = new jobListBucketPenalizedTime_t(*it->second);
+        copy->predecessors.clear();
+        copy->successors.clear();
+        copy->pendingEvents.clear();
+        return copy;
+    }
+
     /**
      * Reset all penalized times associated to all buckets or one bucket
      */
@@ -1300,6 +1318,36 @@ namespace Simulator {
     uint32_t Job::getslurmprio() {
         return slurmprio;
     }
+
+    /*
+     * Sets the time when the job became eligible to run, SLURM ages its priority from it
+     * @param theValue The eligible time
+     */
+    void Job::setslurmEligibleTime(double theValue) {
+        slurmEligibleTime = theValue;
+    }
+
+    /*
+     * Gets the time when the job became eligible to run
+     */
+    double Job::getslurmEligibleTime() {
+        return slurmEligibleTime;
+    }
+
+    /*
+     * Sets the weighted multifactor priority of SLURM without the age factor
+     * @param theValue The weighted factors
+     */
+    void Job::setslurmFactors(double theValue) {
+        slurmFactors = theValue;
+    }
+
+    /*
+     * Gets the weighted multifactor priority of SLURM without the age factor
+     */
+    double Job::getslurmFactors() {
+        return slurmFactors;
+    }
     
     int Job::getDelaySec(){
         return nmetric_delaysec;
@@ -1348,5 +1396,75 @@ namespace Simulator {
     void Job::setPreceedingJobs(vector<int> theValue) {
         preceeding_jobs = theValue;
     }
+
+    /**
+     * Adds a preceeding job that is in the workload, the job becomes one of its successors
+     * @param job The preceeding job
+     */
+    void Job::addPredecessor(Job* job) {
+        predecessors.push_back(job);
+        job->successors.push_back(this);
+    }
+
+    /**
+     * Returns the preceeding jobs that are in the workload
+     * @return The preceeding jobs
+     */
+    vector<Job*>& Job::getPredecessors() {
+        return predecessors;
+    }
+
+    /**
+     * Returns the jobs that have this one as a preceeding job
+     * @return The succeeding jobs
+     */
+    vector<Job*>& Job::getSuccessors() {
+        return successors;
+    }
+
+    /**
+     * Returns the number of preceeding jobs that have not finished yet
+     * @return The number of unmet preceeding jobs
+     */
+    int Job::getUnmetPredecessors() {
+        return unmet_predecessors;
+    }
+
+    /**
+     * Sets the number of preceeding jobs that have not finished yet
+     * @param theValue The number of unmet preceeding jobs
+     */
+    void Job::setUnmetPredecessors(int theValue) {
+        unmet_predecessors = theValue;
+    }
+
+    /**
+     * Registers an event of the job that has been inserted in the simulation event queue
+     * @param event The pending event
+     */
+    void Job::addPendingEvent(SimulationEvent* event) {
+        pendingEvents.push_back(event);
+    }
+
+    /**
+     * Forgets an event of the job once it has left the simulation event queue
+     * @param event The event to forget
+     */
+    void Job::removePendingEvent(SimulationEvent* event) {
+        for (vector<SimulationEvent*>::iterator it = pendingEvents.begin(); it != pendingEvents.end(); ++it) {
+            if (*it == event) {
+                pendingEvents.erase(it);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Returns the handles to the events of the job that are still pending in the simulation
+     * @return A reference to the vector of pending events
+     */
+    vector<SimulationEvent*>& Job::getPendingEvents() {
+        return pendingEvents;
+    }
     
 }
@@ -32,6 +32,7 @@ using std::vector;
 
 namespace Simulator {
 
+    class SimulationEvent;
 
     // key is start time and value is a penalized time
     typedef map<double, double> jobListBucketPenalizedTime_t;
@@ -76,6 +77,7 @@ namespace Simulator {
         //Constructors and destructors
         Job();
         ~Job();
+        Job* clone() const;
         //Set and get methods
         void resetBucketPenalizedTime(int bucketId = -1);
         void addBucketPenalizedTime(int bucketId, double startTime, double endTime, double penalizedTime);
@@ -217,6 +219,10 @@ namespace Simulator {
         
         void setslurmprio(uint32_t value);
         uint32_t getslurmprio();
+        void setslurmEligibleTime(double value);
+        double getslurmEligibleTime();
+        void setslurmFactors(double value);
+        double getslurmFactors();
         
         int getDelaySec();
         void setDelaySec(int theValue);
@@ -235,6 +241,15 @@ namespace Simulator {
         
         vector<int> getPreceedingJobs();
         void setPreceedingJobs(vector<int> theValue);
+        void addPredecessor(Job* job);
+        vector<Job*>& getPredecessors();
+        vector<Job*>& getSuccessors();
+        int getUnmetPredecessors();
+        void setUnmetPredecessors(int theValue);
+
+        void addPendingEvent(SimulationEvent* event);
+        void removePendingEvent(SimulationEvent* event);
+        vector<SimulationEvent*>& getPendingEvents();
         
 
     private:
@@ -333,12 +348,19 @@ Note that when values are rounded to an integral number of seconds (as often hap
         int maxMemory; /**< Maximum memory a job can use */
         
         uint32_t slurmprio; // The priority used by SLURM to decide when to schedule jobs.
+        double slurmEligibleTime; // When the job became eligible to run, SLURM ages its priority from then.
+        double slurmFactors; // The weighted multifactor priority of SLURM without the age, it is part of the key of the SLURM queues.
         double io_to_runtime_ratio; // The split between io and computation. 0.2 means 0.2 * total runtime = iotime; 1-0.2 * total runtime = computation time;
         
         int workflow_id;
         int workflow_status;
         
         vector<int> preceeding_jobs;
+        vector<Job*> predecessors; /**< The preceeding jobs that are in the workload, resolved when the trace is loaded */
+        vector<Job*> successors; /**< The jobs that have this one as a preceeding job */
+        int unmet_predecessors; /**< The preceeding jobs that have not finished yet, including the ones that are not in the workload */
+
+        vector<SimulationEvent*> pendingEvents; /**< Handles to the START, TERMINATION and TRANSITION events of the job that are still in the simulation event queue */
     };
 }
 #endif
@@ -0,0 +1,266 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/nodetimeline.h>
+#include <archdatamodel/node.h>
+
+#include <algorithm>
+#include <functional>
+#include <assert.h>
+
+namespace Simulator {
+
+    /** Order used to look for the segment that contains a given time. */
+    struct SegmentStartTime_lt_t {
+
+        bool operator()(double time, const TimelineSegment& seg) const {
+            return time < seg.startTime;
+        }
+    };
+
+    /**
+     * The constructor for the class. The timeline starts with a single segment with all the resources of the node free.
+     * @param node The node whose state is represented
+     * @param startTime The first time of the timeline
+     */
+    NodeTimeline::NodeTimeline(ArchDataModel::Node* node, double startTime) {
+        this->node = node;
+
+        TimelineSegment free;
+        free.startTime = startTime;
+        free.endTime = -1;
+        free.freeCPUs = node->getNumberCPUs();
+        free.freeMemory = node->getMemorySize();
+        free.freeDisk = node->getDiskSize();
+        free.freeMemoryBW = node->getMemoryBW();
+        free.freeDiskBW = node->getDiskBW();
+        free.freeFabricBW = node->getFabricBW();
+        free.reservationsStarting = 0;
+        free.reservationsEnding = 0;
+        this->segments.push_back(free);
+    }
+
+    /**
+     * The default destructor for the class
+     */
+    NodeTimeline::~NodeTimeline() {
+    }
+
+    /**
+     * Returns the node whose state is represented by the timeline
+     * @return The node
+     */
+    ArchDataModel::Node* NodeTimeline::getNode() const {
+        return this->node;
+    }
+
+    /**
+     * Returns the segments of the timeline, sorted by startTime
+     * @return A reference to the segments
+     */
+    const vector<TimelineSegment>& NodeTimeline::getSegments() const {
+        return this->segments;
+    }
+
+    /**
+     * Returns the position of the segment that contains a given time (the last one that starts before or at time).
+     * @param time The time to look for, the first segment is returned for the times before the start of the timeline
+     * @return The position of the segment
+     */
+    size_t NodeTimeline::findSegment(double time) const {
+        vector<TimelineSegment>::const_iterator it = std::upper_bound(this->segments.begin(), this->segments.end(), time, SegmentStartTime_lt_t());
+        if (it == this->segments.begin()) //the past has been trimmed, the first segment stands for it.
+            return 0;
+        return (it - this->segments.begin()) - 1;
+    }
+
+    /**
+     * Substracts the resources rl from the node between startTime and endTime, breaking down the segments that
+     * contain them if required.
+     * @param startTime The first time of the reservation
+     * @param endTime The last time of the reservation
+     * @param rl The resources to reserve
+     */
+    void NodeTimeline::reserve(double startTime, double endTime, const ReservationList& rl) {
+        assert(endTime != -1 and startTime <= endTime);
+        if (startTime < this->segments.front().startTime)
+            startTime = this->segments.front().startTime;
+        assert(startTime <= endTime);
+
+        size_t first = this->split(startTime);
+        size_t last = this->split(endTime + 1);
+
+        for (size_t pos = first; pos < last; pos++) {
+            TimelineSegment& seg = this->segments[pos];
+            assert(rl.cpus <= seg.freeCPUs);
+            assert(rl.mem <= seg.freeMemory);
+            assert(rl.disk <= seg.freeDisk);
+            assert(rl.memBW <= seg.freeMemoryBW);
+            assert(rl.diskBW <= seg.freeDiskBW);
+            assert(rl.fabBW <= seg.freeFabricBW);
+
+            seg.freeCPUs -= rl.cpus;
+            seg.freeMemory -= rl.mem;
+            seg.freeDisk -= rl.disk;
+            seg.freeMemoryBW -= rl.memBW;
+            seg.freeDiskBW -= rl.diskBW;
+            seg.freeFabricBW -= rl.fabBW;
+        }
+
+        this->segments[first].reservationsStarting++;
+        this->segments[last - 1].reservationsEnding++;
+    }
+
+    /**
+     * Gives back the resources rl previously reserved between startTime and endTime, and joins the segments
+     * at both ends of the reservation if they become the same.
+     * @param startTime The first time of the reservation
+     * @param endTime The last time of the reservation
+     * @param rl The resources that were reserved
+     */
+    void NodeTimeline::release(double startTime, double endTime, const ReservationList& rl) {
+        if (startTime < this->segments.front().startTime)
+            startTime = this->segments.front().startTime;
+        size_t first = this->findSegment(startTime);
+        size_t last = this->findSegment(endTime + 1);
+        assert(this->segments[first].startTime == startTime);
+        assert(this->segments[last].startTime == endTime + 1);
+
+        for (size_t pos = first; pos < last; pos++) {
+            TimelineSegment& seg = this->segments[pos];
+            seg.freeCPUs += rl.cpus;
+            seg.freeMemory += rl.mem;
+            seg.freeDisk += rl.disk;
+            seg.freeMemoryBW += rl.memBW;
+            seg.freeDiskBW += rl.diskBW;
+            seg.freeFabricBW += rl.fabBW;
+        }
+
+        assert(this->segments[first].reservationsStarting > 0 and this->segments[last - 1].reservationsEnding > 0);
+        this->segments[first].reservationsStarting--;
+        this->segments[last - 1].reservationsEnding--;
+
+        //the end goes first, joining it never moves the first segment.
+        this->join(last);
+        this->join(first);
+    }
+
+    /**
+     * Removes the segments that are before time, the segment that contains time begins at it afterwards. The reservations
+     * that began in the removed segments are moved to the new first segment. A segment where a reservation that is still
+     * there finishes is kept, so the timeline may begin before time.
+     * @param time The time before which the segments are not needed anymore
+     * @return The start time of the timeline after trimming it
+     */
+    double NodeTimeline::trim(double time) {
+        size_t pos = this->findSegment(time);
+
+        size_t first = 0;
+        uint32_t reservationsStarting = 0;
+        while (first < pos and this->segments[first].reservationsEnding == 0) {
+            reservationsStarting += this->segments[first].reservationsStarting;
+            first++;
+        }
+
+        if (first == pos and this->segments[pos].startTime < time)
+            this->segments[pos].startTime = time;
+        this->segments[first].reservationsStarting += reservationsStarting;
+        this->segments.erase(this->segments.begin(), this->segments.begin() + first);
+
+        return this->segments.front().startTime;
+    }
+
+    /**
+     * Returns a hash of the segments, two timelines with the same segments have the same hash.
+     * @return The hash
+     */
+    size_t NodeTimeline::getHash() const {
+        std::hash<double> hashTime;
+        size_t hash = this->segments.size();
+        for (vector<TimelineSegment>::const_iterator it = this->segments.begin(); it != this->segments.end(); ++it) {
+            hash = hash * 31 + hashTime(it->startTime);
+            hash = hash * 31 + it->freeCPUs;
+            hash = hash * 31 + it->freeMemory;
+            hash = hash * 31 + it->reservationsStarting;
+        }
+        return hash;
+    }
+
+    /**
+     * Returns true if the other timeline has exactly the same segments, resources and reservation boundaries,
+     * so any reservation or release would change both of them in the same way. The nodes are not compared.
+     * @param other The timeline to compare with
+     * @return True if the segments are the same
+     */
+    bool NodeTimeline::sameSegments(const NodeTimeline& other) const {
+        if (this->segments.size() != other.segments.size())
+            return false;
+
+        for (size_t pos = 0; pos < this->segments.size(); pos++) {
+            const TimelineSegment& seg = this->segments[pos];
+            const TimelineSegment& otherSeg = other.segments[pos];
+            if (seg.startTime != otherSeg.startTime or seg.endTime != otherSeg.endTime or
+                    seg.reservationsStarting != otherSeg.reservationsStarting or seg.reservationsEnding != otherSeg.reservationsEnding or
+                    not seg.sameResources(otherSeg))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Makes sure that a segment starts at time, the segment that contains it is broken down otherwise.
+     * | seg                  | (before)
+     * | seg      | newSeg    | (after, newSeg starts at time)
+     * @param time The time where a segment has to start
+     * @return The position of the segment that starts at time
+     */
+    size_t NodeTimeline::split(double time) {
+        size_t pos = this->findSegment(time);
+        if (this->segments[pos].startTime == time)
+            return pos;
+
+        TimelineSegment newSeg = this->segments[pos];
+        newSeg.startTime = time;
+        newSeg.reservationsStarting = 0;
+        this->segments[pos].endTime = time - 1;
+        this->segments[pos].reservationsEnding = 0;
+        this->segments.insert(this->segments.begin() + pos + 1, newSeg);
+        return pos + 1;
+    }
+
+    /**
+     * Joins the segment at pos with the previous one if no reservation begins or finishes between them.
+     * @param pos The position of the second segment
+     */
+    void NodeTimeline::join(size_t pos) {
+        if (pos == 0 or pos >= this->segments.size())
+            return;
+
+        TimelineSegment& prev = this->segments[pos - 1];
+        const TimelineSegment& seg = this->segments[pos];
+        if (prev.reservationsEnding != 0 or seg.reservationsStarting != 0 or not prev.sameResources(seg))
+            return;
+
+        prev.endTime = seg.endTime;
+        prev.reservationsEnding = seg.reservationsEnding;
+        this->segments.erase(this->segments.begin() + pos);
+    }
+
+}
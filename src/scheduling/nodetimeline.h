@@ -0,0 +1,143 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATORNODETIMELINE_H
+#define SIMULATORNODETIMELINE_H
+
+#include <scheduling/resourcebucket.h>
+#include <vector>
+
+using std::vector;
+
+namespace ArchDataModel {
+    class Node;
+}
+
+namespace Simulator {
+
+    /**
+     * A contiguous interval of time of a node with the same free resources. Segments are stored by value,
+     * so the free resources are found without following any pointer. Which jobs are reserved in the
+     * segment is not stored here, it is kept by the reservation table in a separated index.
+     */
+    struct TimelineSegment {
+        double startTime; /**< The first time of the segment */
+        double endTime; /**< The last time of the segment, -1 for the last segment of the node */
+        uint32_t freeCPUs;
+        uint64_t freeMemory;
+        uint64_t freeDisk;
+        double freeMemoryBW;
+        double freeDiskBW;
+        double freeFabricBW;
+        uint32_t reservationsStarting; /**< The number of reservations that begin at startTime */
+        uint32_t reservationsEnding; /**< The number of reservations that finish at endTime */
+
+        /** Keeps the common minimum of the free resources of this segment and seg. */
+        void restrictTo(const TimelineSegment& seg) {
+            freeCPUs = (freeCPUs <= seg.freeCPUs) ? freeCPUs : seg.freeCPUs;
+            freeMemory = (freeMemory <= seg.freeMemory) ? freeMemory : seg.freeMemory;
+            freeDisk = (freeDisk <= seg.freeDisk) ? freeDisk : seg.freeDisk;
+            freeMemoryBW = (freeMemoryBW <= seg.freeMemoryBW) ? freeMemoryBW : seg.freeMemoryBW;
+            freeDiskBW = (freeDiskBW <= seg.freeDiskBW) ? freeDiskBW : seg.freeDiskBW;
+            freeFabricBW = (freeFabricBW <= seg.freeFabricBW) ? freeFabricBW : seg.freeFabricBW;
+        }
+
+        /** Returns true if this segment has at least one free resource with a higher value than seg. */
+        bool hasMoreResources(const TimelineSegment& seg) const {
+            return freeCPUs > seg.freeCPUs or freeMemory > seg.freeMemory or freeDisk > seg.freeDisk or
+                    freeMemoryBW > seg.freeMemoryBW or freeDiskBW > seg.freeDiskBW or freeFabricBW > seg.freeFabricBW;
+        }
+
+        /** Returns true if this segment and seg have the same free resources. */
+        bool sameResources(const TimelineSegment& seg) const {
+            return freeCPUs == seg.freeCPUs and freeMemory == seg.freeMemory and freeDisk == seg.freeDisk and
+                    freeMemoryBW == seg.freeMemoryBW and freeDiskBW == seg.freeDiskBW and freeFabricBW == seg.freeFabricBW;
+        }
+
+        /** Builds a ReservationList from the free resources of the segment. */
+        ReservationList getResourceList() const {
+            ReservationList rl = {.cpus = freeCPUs, .disk = freeDisk,
+                .mem = freeMemory, .memBW = freeMemoryBW,
+                .diskBW = freeDiskBW, .fabBW = freeFabricBW};
+            return rl;
+        }
+    };
+
+    /**
+     * The free resources that a node can offer along an interval of time, the common minimum of the segments
+     * that overlap it. Windows are values: they are evaluated on the stack and only the ones chosen for an
+     * allocation are turned into ResourceBuckets.
+     */
+    struct AvailabilityWindow {
+        uint32_t id; /**< The index of the node in the reservation table */
+        ArchDataModel::Node* node; /**< The node that offers the resources */
+        double startTime;
+        double endTime;
+        uint32_t freeCPUs;
+        uint64_t freeMemory;
+        uint64_t freeDisk;
+        double freeMemoryBW;
+        double freeDiskBW;
+        double freeFabricBW;
+        double timeNextRelease; /**< Start time of the next release of resources in the node, -1 if there is none */
+    };
+
+    /** A reservation made by a job in one node of the reservation table. */
+    struct TimelineReservation {
+        uint32_t node; /**< The index of the node in the reservation table */
+        double startTime;
+        double endTime;
+        ReservationList rl; /**< The resources reserved in every segment between startTime and endTime */
+    };
+
+    /**
+     * The reservation state of a node along the time. The segments are kept sorted by their start time in
+     * a contiguous vector and they cover the time from the creation of the timeline to the infinite without gaps
+     * (the endTime of a segment plus one is the startTime of the next one). Two neighbour segments are joined
+     * as soon as no reservation begins or finishes between them. The past can be trimmed, the reservations that
+     * began before the first segment are taken as beginning at it.
+     */
+    class NodeTimeline {
+    public:
+        NodeTimeline(ArchDataModel::Node* node, double startTime);
+        ~NodeTimeline();
+
+        ArchDataModel::Node* getNode() const;
+        const vector<TimelineSegment>& getSegments() const;
+        size_t findSegment(double time) const;
+
+        void reserve(double startTime, double endTime, const ReservationList& rl);
+        void release(double startTime, double endTime, const ReservationList& rl);
+        double trim(double time);
+
+        size_t getHash() const;
+        bool sameSegments(const NodeTimeline& other) const;
+
+    private:
+        size_t split(double time);
+        void join(size_t pos);
+
+        ArchDataModel::Node* node; /**< The node whose state is represented by the timeline */
+        vector<TimelineSegment> segments; /**< The segments of the node, sorted by startTime */
+    };
+
+}
+
+#endif
@@ -24,7 +24,14 @@
 
 namespace Simulator {
 
-    Partition::Partition(double startTime, Utils::Log *log) {
+    /**
+     * Creates a partition whose reservation table is a view over the given store, so its nodes keep a single timeline
+     * shared with the reservation table of the system orchestrator.
+     * @param startTime The start time of the simulation
+     * @param log A reference to the logging engine
+     * @param store The store where the timelines of the nodes are kept
+     */
+    Partition::Partition(double startTime, Utils::Log *log, TimelineStore *store) {
         this->name = "";
         this->numNodes = 0;
         this->cpus = 0;
@@ -34,10 +41,20 @@ namespace Simulator {
         this->rspolicyType = FF_AND_FCF;
         this->globalTime = 0;
         this->log = log;
-        this->rt = new ResourceReservationTable(log, globalTime);
+        this->rt = new ResourceReservationTable(store, log, globalTime);
         this->policy = NULL;
     }
 
+    /**
+     * The destructor for the class, the policy frees the reservation table
+     */
+    Partition::~Partition() {
+        if (this->policy != NULL)
+            delete this->policy;
+        else
+            delete this->rt;
+    }
+
     void Partition::setGlobalTime(uint64_t globalTime) {
         this->globalTime = globalTime;
         this->rt->setGlobalTime(globalTime);
@@ -50,7 +67,7 @@ namespace Simulator {
     }
 
     void Partition::setReservationTable(ResourceReservationTable *rt) {
-        this->log->debug("Partition::setRT");
+        LOG_DEBUG(this->log, "Partition::setRT", 1);
         cout << "Partition::setRT (cout)" << endl;
         this->rt = rt;
     }
@@ -111,6 +128,21 @@ namespace Simulator {
         disk = node->getDiskSize();
     }
 
+    /**
+     * Moves the nodes of the partition to a reservation table with a store of its own, so the partition does not share
+     * any state with the others and can be scheduled at the same time as them. The nodes keep their order, and so their
+     * ids in the table. It has to be done before the policy is set, while there are no reservations.
+     * @param startTime The time when the timelines of the nodes begin, as in the shared store
+     */
+    void Partition::separateStore(double startTime) {
+        assert(this->policy == NULL);
+        ResourceReservationTable *own = new ResourceReservationTable(this->log, startTime);
+        for (uint32_t i = 0; i < this->rt->getNumberOfNodes(); i++)
+            own->addNode(this->rt->getNode(i));
+        delete this->rt;
+        this->rt = own;
+    }
+
     ArchDataModel::Node *Partition::removeNode(uint32_t nodeid) {
         assert(false);
         /*std::set<ArchDataModel::Node*>::iterator n = nodes.find(nodeid);
@@ -37,6 +37,7 @@ namespace Simulator {
 class ResourceSchedulingPolicy;
 class ResourceReservationTable;
 class SchedulingPolicy;
+class TimelineStore;
 class Simulation;
 
 
@@ -49,8 +50,8 @@ struct nodeid_lt_t {
 class Partition {
 public:
 	Partition();
-	Partition(double startTime, Utils::Log *log);
-	~Partition();
+	Partition(double startTime, Utils::Log *log, TimelineStore *store);
+	virtual ~Partition();
 
 	ResourceReservationTable *getReservationTable();
 	void setReservationTable(ResourceReservationTable *rt);
@@ -60,6 +61,7 @@ public:
 	void setSchedulingPolicy(ResourceSchedulingPolicy *policy);
 
 	void addNode(ArchDataModel::Node *node);
+	void separateStore(double startTime);
 	ArchDataModel::Node *removeNode(uint32_t nodeid);
 	
 	//Get information about the partition and its nodes.
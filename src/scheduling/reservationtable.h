@@ -81,7 +81,7 @@ public:
   
   /* returns the previous done allocation for the given*/
   ResourceJobAllocation* getJobAllocation(Job* job);
-  void setGlobalTime(double theValue);
+  virtual void setGlobalTime(double theValue);
   double getGlobalTime() const;
   void setInitialGlobalTime(double theValue);
   double getinitialGlobalTime() const;
@@ -119,6 +119,22 @@ namespace Simulator {
 
     }
 
+    /**
+     * Adds the window of a node that could host the job
+     * @param window The window found by the reservation table
+     */
+    void ResourceJobAllocation::addCandidate(const AvailabilityWindow& window) {
+        candidates.push_back(window);
+    }
+
+    /**
+     * Returns the windows of the nodes that could host the job, the scheduling policy chooses the buckets of the allocation among them
+     * @return A reference to the windows
+     */
+    const std::vector<AvailabilityWindow>& ResourceJobAllocation::getCandidates() const {
+        return candidates;
+    }
+
     /**
      * When an allocation returned by the reservation table or by the scheduling policies has some problem it will return a double indicating when a possible allocation would be available that matches the requirement . For instance, that there are not enough cpus at the required time.
      * @return A double indicating a proposal of a time stamp when there would be an allocation matching the requirements.
@@ -23,6 +23,7 @@
 
 #include <scheduling/joballocation.h>
 #include <scheduling/resourcebucket.h>
+#include <scheduling/nodetimeline.h>
 
 #include <deque>
 #include <vector>
@@ -46,6 +47,8 @@ namespace Simulator {
         void setAllocations(const deque<ResourceBucket*>& allocs);
         void addAllocations(deque< ResourceBucket* >& allocs);
         std::deque<ResourceBucket*> getAllocations() const;
+        void addCandidate(const AvailabilityWindow& window);
+        const std::vector<AvailabilityWindow>& getCandidates() const;
 
         void setNextStartTimeToExplore(double nextStartTime);
         double getNextStartTimeToExplore() const;
@@ -55,6 +58,7 @@ namespace Simulator {
 
     private:
         std::deque<ResourceBucket*> allocations; /**< Buckets associated to the current allocation */
+        std::vector<AvailabilityWindow> candidates; /**< The windows of the nodes that could host the job, from which the buckets of the allocation are chosen */
         double nextStartTimeToExplore; /**< this variable inidicates where to explore if this allocation is not satisfactory for the ones who asked for this */
         
 
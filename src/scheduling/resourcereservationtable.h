@@ -1,29 +1,31 @@
-/*
-* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
-* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
-* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
-*
-* This file is part of NEXTGenSim.
-*
-* NEXTGenSim is free software: you can redistribute it and/or modify
-* it under the terms of the GNU General Public License as published by
-* the Free Software Foundation, either version 3 of the License, or
-* (at your option) any later version.
-*
-* NEXTGenSim is distributed in the hope that it will be useful,
-* but WITHOUT ANY WARRANTY; without even the implied warranty of
-* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-* GNU General Public License for more details.
-* 
-* You should have received a copy of the GNU General Public License
-* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
-*/
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
 #ifndef RESOURCERESERVATIONTABLE_H
 #define RESOURCERESERVATIONTABLE_H
 
 #include <scheduling/reservationtable.h>
 #include <scheduling/metric.h>
 #include <scheduling/resourcebucket.h>
+#include <scheduling/nodetimeline.h>
+#include <scheduling/timelinestore.h>
 
 #include <set>
 #include <vector>
@@ -54,29 +56,6 @@ namespace Simulator {
     class ResourceJobAllocation;
     class Job;
 
-    /** This struct implements the order function for the set of buckets ordered by the startime of the buckets.
-     * The buckets with the lowest startTime goest first.
-     * In case of same startime the buckets are compared with their cpu,
-     * and in case of the same cpu the buckets are compared with their id.*/
-    struct ABucket_StartTime_lt_t {
-
-        bool operator()(ResourceBucket* b1, ResourceBucket* b2) const {
-
-            double x = b1->getStartTime();
-            double y = b2->getStartTime();
-
-            assert(x >= 0 && y >= 0);
-
-            if (x != y)
-                return x < y; //Lower startTime goes first
-            else
-                return b1->getID() < b2->getID();
-        }
-    };
-
-
-    /** Defines a BucketSetOrdered that is a set of ResourceBuckets ordered with the startime */
-    typedef set<ResourceBucket*, ABucket_StartTime_lt_t> BucketSetOrdered;
     /** Defines a pair of job and job allocation */
     typedef pair<Job*, JobAllocation*> pairJobAlloc;
     /** Defines a pair of job and ResourceBucket */
@@ -94,10 +73,10 @@ namespace Simulator {
 
     /**  
      * This function implements a Resource Reservation Table. This will be used by the scheduler for map jobs in the cpus along the time. 
-     * IMPORTANT ! ALWAYS THAT THE STARTTIME FOR A GIVEN BUCKET CHANGES IT MUST BE ERASED AND REINSERTED IN THE LIST 
-     * IF NOT , THE STRIC ORDER OF THE FOLLOWING FUNCTION MAY LOSE ITS FUNCTIONALITY 
-     *  
-     * USE void updateStartTimeFreeBucket(ResourceBucket* bucket,double startTime) for update safely the bucket startime for an already inserted bucket
+     * The state of every node is kept in a NodeTimeline, and the reservations done by every job are kept apart in jobReservations
+     * so allocating or deallocating a job does not need to look for the job in the segments.
+     * The timelines are kept in a TimelineStore, the table is a view over a range of its nodes, so the tables of the
+     * system and of the partitions share a single timeline per node.
      */
     class ResourceReservationTable : public ReservationTable {
     public:
@@ -105,11 +84,30 @@ namespace Simulator {
         /* Constructors and desctructors*/
         ResourceReservationTable(std::vector<ArchDataModel::Node*> nodes, Utils::Log* log, uint64_t globalTime);
         ResourceReservationTable(Utils::Log* log, uint64_t globalTime);
+        ResourceReservationTable(TimelineStore* store, Utils::Log* log, uint64_t globalTime);
         ResourceReservationTable();
         ~ResourceReservationTable();
 
         void addNode(ArchDataModel::Node* node);
         void removeNode(ArchDataModel::Node* node);
+        TimelineStore* getTimelineStore() const;
+        uint32_t getNumberOfNodes() const;
+        ArchDataModel::Node* getNode(uint32_t bId) const;
+        uint64_t getVersion() const;
+        void setNodePools(bool nodePools);
+        bool getNodePools() const;
+        uint32_t getNumberOfPools() const;
+        void setReserveFullNode(bool reserveFullNode);
+        bool getReserveFullNode() const;
+        void setEarliestStartSearch(bool earliestStartSearch);
+        bool getEarliestStartSearch() const;
+        void setGlobalTime(double theValue);
+
+        /* what-if transactions over the table */
+        void beginTransaction();
+        void commitTransaction();
+        void discardTransaction();
+        bool inTransaction() const;
 
         /* auxiliar functions mainly used by the deepsearch policy*/
 
@@ -128,44 +126,36 @@ namespace Simulator {
         bool expandJobAllocation(Job* job, JobAllocation* jobAlloc);
         bool shrinkJobAllocation(Job* job, int scpus);
 
-        BucketSetOrdered::iterator findLowerBound(BucketSetOrdered* bucketSet, ResourceBucket* current);
-        BucketSetOrdered::iterator findUpperBound(BucketSetOrdered* bucketSet, ResourceBucket* current);
-
-
         /* auxuliar methods */
-        BucketSetOrdered* findFirstBucketCpus(double time, double length);
         ResourceBucket* findFirstBucketProcessor(double time, double length, int processor);
 
-        /* The following methods are the once we used in the past  
-           The first once is based on an iterative method that may be faster but do not explore deep in to the search space (it discarts some possible allocations). It may be more costly if this function it's called many times in order to find the solution. (Two different variants for this method).*/
-        ResourceJobAllocation* findFastConsecutiveMethodAllocation(BucketSetOrdered* suitableBuckets, double length, int numCpus, double initialShadow);
-        ResourceJobAllocation* findFastMethodAllocation(BucketSetOrdered* suitableBuckets, double length, int numCpus, double initialShadow);
-        /* - The second on it's a litle bit more smart. In the sense it construct a matrixs with meta data and explores all the possible results in a smarter way. It creates a meta data. */
-        ResourceJobAllocation* findSmartMethodAllocation(BucketSetOrdered* suitableBuckets, double length, int numCpus, double initialShadow);
-
-
         bool shareEnoughTime(ResourceBucket* bucket1, ResourceBucket* bucket2, double length);
         void freeAllocation(ResourceJobAllocation* allocationForCheckingReq);
 
-        vector<BucketSetOrdered*>* getBuckets();
+        const NodeTimeline& getTimeline(uint32_t bId) const;
 
-        ResourceJobAllocation* findPossibleAllocation(Job* job, double time, double length, std::vector<uint32_t> pnodes = {});
-        ResourceBucket* findFirstBucket(double time, double runtime, int bId);
+        ResourceJobAllocation* findPossibleAllocation(Job* job, double time, double length, const std::vector<uint32_t>& pnodes = std::vector<uint32_t>());
+        AvailabilityWindow findFirstWindow(double time, double runtime, uint32_t bId);
+        double findEarliestStart(Job* job, double time, double length);
 
 
-        void dumpAllBucketSetsAndCheck(BucketSetOrdered* allocations, BucketSetOrdered* globalView, BucketSetOrdered* buckets);
-
+        void dumpTimeline(uint32_t bId);
 
 
     protected:
 
-        void dumpBucketSet(BucketSetOrdered* setBuckets);
-        void checkBucketSet(BucketSetOrdered* setBuckets);
-        void printBucketSetOrdered(BucketSetOrdered* bs, uint32_t id, uint32_t setid);
-
-        void updateStartTimeFreeBucket(ResourceBucket* bucket, double startTime); /**< function that updates safely a bucket already inserted in the local sets - avoids violate the strict order of the set*/
-
-        vector<BucketSetOrdered*> buckets; /**< the resource reservation table. A BucketSetOrdered per Resource. */
+        void reserveJob(Job* job, uint32_t bId, double startTime, double endTime, const ReservationList& rl);
+        void reserveInNode(uint32_t bId, double startTime, double endTime, const ReservationList& rl);
+        void releaseInNode(uint32_t bId, double startTime, double endTime, const ReservationList& rl);
+        AvailabilityWindow findFirstWindow(double time, double runtime, uint32_t bId, vector<AvailabilityWindow>& windows);
+
+        TimelineStore* store; /**< the timelines of the nodes of the table, they may be shared with other tables */
+        bool ownStore; /**< true if the store was created by the table and has to be deleted with it */
+        uint32_t view; /**< the view of the store seen by the table, the position of a node in it is the id used in its buckets */
+        map<Job*, vector<TimelineReservation> > jobReservations; /**< the reservations done by each job in the timeline */
+        bool transaction; /**< true while the changes are done in the overlay of the store */
+        map<Job*, pair<ResourceJobAllocation*, vector<TimelineReservation> > > transactionReleased; /**< the jobs allocated before the transaction and deallocated in it, with their allocation and reservations */
+        set<Job*> transactionAllocated; /**< the jobs allocated in the transaction */
 
     };
 
@@ -104,6 +104,8 @@ ResourceJobAllocation* ResourceSchedulingPolicy::findAllocation(Job* job, double
 
 	while(!allocated)
 	{
+		//the nodes are only explored once the whole system has enough free resources for the job
+		startTime = ((ResourceReservationTable*)this->reservationTable)->findEarliestStart(job, startTime, runtime);
 		ResourceJobAllocation* possibleAllocation =
 				((ResourceReservationTable*)this->reservationTable)->findPossibleAllocation(job, startTime,runtime);
 		
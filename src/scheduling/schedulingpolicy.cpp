@@ -51,6 +51,7 @@ namespace Simulator {
         AccumulatedRT = 0;
         FinishedJobs = 0;
         log = NULL;
+        reservationTable = NULL;
         powerAware = false;
         simulateResourceUsage = false;
         power = NULL;
@@ -23,16 +23,24 @@
 #include <scheduling/systemorchestrator.h>
 #include <scheduling/swftracefile.h>
 #include <scheduling/partition.h>
+#include <utils/threadpool.h>
 
 #include "resourceschedulingpolicy.h"
 
+#include <algorithm>
+
 namespace Simulator {
 
+    thread_local vector<DeferredEvent>* Simulation::deferredEvents = NULL;
+    volatile sig_atomic_t Simulation::stopRequests = 0;
+    volatile sig_atomic_t Simulation::statisticsRequests = 0;
+
     /**
      * The default constructor for the class
      */
 
     Simulation::Simulation() {
+        this->events = new HeapEventQueue();
     }
 
     /**
@@ -52,6 +60,7 @@ namespace Simulator {
         this->SlowdownBound = -1;
         //we copy a reference of the job list in to the scheduling policy that will be used by some scheduler policies
         this->collectStatisticsInterval = 10 * 60; //by default each 10 minutes the policy statistics will be collected
+        this->backfillInterval = 0;
         this->policyCollector = new PolicyEntityCollector((SchedulingPolicy*) sysOrch->getPolicy(), log);
         this->JobsSimulationPerformance = NULL;
         this->PolicySimulationPerformance = NULL;
@@ -64,6 +73,22 @@ namespace Simulator {
         this->lastProcessedJob = 0;
         this->usefull = 0;
         this->numberOfFinishedJobs = 0;
+        this->currentEvent = NULL;
+        this->currentJob = NULL;
+        this->nextOrderedJob = 0;
+        this->nextArrival = NULL;
+        this->nextArrivalId = 0;
+        this->events = new HeapEventQueue();
+        this->eventQueueType = HEAP_EVENT_QUEUE;
+        this->totals = SimulationTotals();
+        this->firstJobStarted = false;
+        this->startTimeFirstJob = 0;
+        this->consecutiveStatisticsCollection = 0;
+        this->partition = NULL;
+        this->partitionEventStreams = false;
+        this->partitionLookahead = 0;
+        this->statisticsRequestsSeen = statisticsRequests;
+        this->reportResults = true;
     }
 
     /**
@@ -71,10 +96,32 @@ namespace Simulator {
      */
 
     Simulation::~Simulation() {
+        delete this->events;
+        delete this->policyCollector;
+    }
+
+    /**
+     * Selects the implementation of the event queue. It must be called before the simulation is initialized.
+     * @param type The event queue implementation
+     */
+    void Simulation::setEventQueueType(event_queue_type_t type) {
+        assert(this->events->empty());
+        delete this->events;
+        this->eventQueueType = type;
+        switch (type) {
+            case CALENDAR_EVENT_QUEUE:
+                LOG_DEBUG(log, "Using the calendar event queue", 1);
+                this->events = new CalendarEventQueue();
+                break;
+            default:
+                LOG_DEBUG(log, "Using the heap event queue", 1);
+                this->events = new HeapEventQueue();
+                break;
+        }
     }
 
     /**
-     * Function that initialize the simulation. It mainly create all the arrival events for all the jobs that have to be simulated. 
+     * Function that initialize the simulation. It mainly prepares the reading of the arrivals of all the jobs that have to be simulated. 
      * @return A boolean indicating if the initialization has been done with  no errors.
      * Doctored by Nick for <reasons>
      * 1. Over generates scheduling events as jobs which can never run still generate schedule calls.
@@ -84,111 +131,36 @@ namespace Simulator {
     bool Simulation::initSimulation() {
         /******************************
          * initialize global data structures.
-         * this includes loading all jobs into the event queue according to their
-         * arrival times.
+         * the arrivals of the jobs are not queued here, they are read from the workload batch by batch while the simulation
+         * advances (see injectArrivals).
          */
 
-        double previous_schedule_time = -1;
         TraceFile* workload = this->SimInfo->getWorkload();
 
-        Job* firstArrival = NULL;
-
-        log->debug("JobList size: " + to_string(workload->JobList.size()), 4);
-        uint32_t jobnum = 0;
-        
-        double firstarrivaltime = 100000000;
-
-
-        for (map<int, Job*>::iterator iter = workload->JobList.begin(); iter != workload->JobList.end(); ++iter) {
-            Job* job = (Job*) iter->second;
-
-            /*
-             * If a job has a runtime of zero, we don;t bother with it.
-             */
-            if (job->getRunTime() == 0) {
-                log->debug("The job " + to_string(job->getJobNumber()) + " has runtime zero, we skip it", 2);
-                continue;
-            }
-
-            /*
-             * Generally, we use ArrivalFactor of 1, ie no tampering with time.
-             */
-            double submittime = ceil(job->getJobSimSubmitTime() * this->ArrivalFactor);
-            job->setJobSimSubmitTime(submittime);
-            
-            
-
-
-            /*
-             * This part quickly checks to see if any jobs uses more CPUs than exists in the system.
-             * If so, the jobs doesn't ARRIVE, and is dropped.
-             */
-            if ((this->SimInfo->getarchConfiguration() == 0 || job->getNumberProcessors() <= (int) this->SimInfo->getarchConfiguration()->getNumberCPUs()) && job->getNumberProcessors() != -1) {
+        LOG_DEBUG(log, "JobList size: " + to_string(workload->JobList.size()), 4);
 
-
-                // Arrive this job
-                SimulationEvent* arrivalEvent = new SimulationEvent(EVENT_ARRIVAL, job, ++this->lastEventId, submittime);
-                log->debug("Adding an EVENT_ARRIVAL event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(submittime), 1);
-                this->events.insert(arrivalEvent);
-
-                /*
-                 * This part adds a scheduling event if (and only if) we have advanced in time since the last arrival
-                 * What does this mean? The idea is to not have a schedule event for every job that arrives at exactly the same time, just one to cover them all.
-                 */
-                if (submittime != previous_schedule_time) {
-                    SimulationEvent* scheduleEvent = new SimulationEvent(EVENT_SCHEDULE, NULL, ++this->lastEventId, submittime);
-                    log->debug("Adding an EVENT_SCHEDULE event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(submittime), 1);
-                    this->events.insert(scheduleEvent);
-                    previous_schedule_time = submittime;
-                } else {
-                    log->debug("Skipping an EVENT_SCHEDULE event for the job " + to_string(job->getJobNumber()) + " the time for the event is " + ftos(submittime), 1);
-                }
-                
-                if (submittime < firstarrivaltime){
-                    firstArrival = job;
-                    firstarrivaltime = submittime;
-                }
-
-
-            } else {
-                job->setJobSimStatus(KILLED_NOT_ENOUGH_RESOURCES);
-                log->error("The job " + to_string(job->getJobNumber()) + " uses " + to_string(job->getNumberProcessors()) + " and the architecture has fewer processors.");
-            }
-            jobnum++;
-        }
-
-
-        SimulationEvent* scheduleEvent = new SimulationEvent(EVENT_SCHEDULE, NULL, ++this->lastEventId, previous_schedule_time);
-        //        log->debug("GlobalTime[" + to_string(globalTime) + "] Adding an EVENT_SCHEDULE event for the LAST job the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(previous_schedule_time), 1);
-        log->debug("Adding an EVENT_SCHEDULE event for the LAST job the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(previous_schedule_time), 1);
-        this->events.insert(scheduleEvent);
-
-        bool do_backfills = true;
-        double bf_timer = firstArrival->getJobSimSubmitTime();
-        double bf_stride = 30;
-        do_backfills = false;
-        if (do_backfills) {
-            for (double t = bf_timer + 1; t < previous_schedule_time; t += bf_stride) {
-                SimulationEvent* backfillEvent = new SimulationEvent(EVENT_BACKFILL, NULL, ++this->lastEventId, t);
-                log->debug("Adding an EVENT_BACKFILL event. The event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(t), 1);
-                this->events.insert(backfillEvent);
-            }
-
-            // Best option is to do some clever pruning of events here, to suppress all the backfills.
+        this->initArrivals();
+        if (this->partitionEventStreams)
+            this->initPartitionSimulations();
+        if (this->partitionSimulations.empty()) {
+            //we set the simulation start time to the arrival of the first job
+            this->nextArrival = this->readNextArrival();
+            if (this->nextArrival != NULL)
+                this->globalTime = this->nextArrival->getJobSimSubmitTime();
         }
-
-
-
-
-        //we set the simulation start time to the initial startTime
-        this->globalTime = firstArrival->getJobSimSubmitTime();
         this->sysOrch->setGlobalTime(globalTime);
         //we create the event for collecting the statistics
         if (this->collectStatisticsInterval > 0) {
-            SimulationEvent* nextCollection = new SimulationEvent(EVENT_COLLECT_STATISTICS, 0, ++this->lastEventId, globalTime + this->collectStatisticsInterval);
-            this->events.insert(nextCollection);
+            SimulationEvent* nextCollection = this->eventPool.newEvent(EVENT_COLLECT_STATISTICS, 0, ++this->lastEventId, globalTime + this->collectStatisticsInterval);
+            this->queueEvent(nextCollection);
             this->pendigStatsCollection++;
         }
+        //the backfill cycles run every backfillInterval seconds, each one queues the next one
+        if (this->backfillInterval > 0 && this->partitionSimulations.empty()) {
+            SimulationEvent* nextBackfill = this->eventPool.newEvent(EVENT_BACKFILL, NULL, ++this->lastEventId, globalTime + this->backfillInterval);
+            this->queueEvent(nextBackfill);
+            LOG_DEBUG(log, "Adding an EVENT_BACKFILL event. The event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(globalTime + this->backfillInterval), 1);
+        }
 
         this->backfillcounter = 0;
 
@@ -200,218 +172,501 @@ namespace Simulator {
      * @return A bool indicating if the simulation has been run successfully.
      */
     bool Simulation::doSimulation() {
-        bool getStartTimeFirstJob = false;
-        double startTimeFirstJob;
-        double total_usage = 0;
-        double total_usage_mem = 0;
-        double full_total_usage = 0;
-        double full_total_usage_mem = 0;
-        double total_slowdown = 0;
-        double total_wait = 0;
         //we tell to the policy that the scheduling will start now
         this->sysOrch->PreProcessScheduling();
-        int ConsecutiveStatisticsCollection = 0;
-        double terminatedJobs = 0;
-        double startedJobs = 0;
-        double totalJobs = this->SimInfo->getWorkload()->getLoadedJobs();
-        log->debug("WORKLOAD LENGTH " + to_string(totalJobs), 1);
+        LOG_DEBUG(log, "WORKLOAD LENGTH " + to_string(this->SimInfo->getWorkload()->getLoadedJobs()), 1);
 
         //         For debugging out of order errors. Generates lots of stdout output.
-        //        if (this->events.size() > 0) {
-        //            for (EventQueue::iterator iter = this->events.begin(); iter != this->events.end(); ++iter) {
+        //        if (this->events->size() > 0) {
+        //            for (EventQueue::iterator iter = this->events->begin(); iter != this->events->end(); ++iter) {
         //                SimulationEvent* event = *iter;
         //                cout << "[" << globalTime << "] ET: " << event->getTime() << "  TYPE: " << event->getType() << "   GT: " << globalTime << endl;
         //            }
         //        }
 
         //return true;
-        /* As we are working with an FCFSF scheduling class we convert the pointer for commodity*/
-        while (this->events.size() > 0 && continueSimulation()) {
-            /*event treatment */
-            EventQueue::iterator iter = this->events.begin();
-            SimulationEvent* event = *iter;
-            this->currentEvent = event;
-            /* update the global to the current time for all the instances that use this time */
-            log->debug("GlobalTime = " + to_string(globalTime) + "  EventTime " + to_string(event->getTime()), 2);
-            assert(globalTime <= event->getTime());
-            this->globalTime = event->getTime();
+        if (!this->partitionSimulations.empty()) {
+            this->runPartitionSimulations();
+        } else {
+            while (this->getNumberOfPendingEvents() > 0 && continueSimulation()) {
+                /*event treatment */
+                this->injectArrivals();
+                this->treatEvent(this->events->top());
+            }
+        }
+        LOG_DEBUG(log, "Simulation has finished, we generate all the statistics and information for the analysis.", 1);
+        /*
+        double wtime = job->getJobSimWaitTime();
+        double rtime = job->getRunTime();
+        int cpus = job->getNumberProcessors();
+        double response = wtime + rtime;
+
+        double usage = cpus*rtime;
+         */
+
+        if (this->reportResults)
+            this->showResults();
+
+        //TODO: Use computePower.
+        //if (policy->computePower())
+        /* print some information about power consumed during workload */
+        //policy->dumpGlobalPowerInformation(globalTime, usefull);
+        //Delete events objects
+        while (!this->events->empty()) {
+            SimulationEvent* foundEvent = this->events->top();
+            this->unqueueEvent(foundEvent);
+            this->eventPool.releaseEvent(foundEvent);
+        }
+        return true; //TODO: Return object
+    }
+
+    /**
+     * Shows the summary of the simulation in the STDOUT and generates the final statistics files
+     */
+    void Simulation::showResults() {
+        //TODO: IMPORTANT - redefine utilization
+        double utilization = this->totals.usage * 100 / ((globalTime - sysOrch->getFirstStartTime()) * sysOrch->getArchitecture()->getNumberCPUs());
+        double utilization_mem = this->totals.usageMem * 100 / ((globalTime - sysOrch->getFirstStartTime())*(sysOrch->getArchitecture()->getTotalMemory() / 1024 / 1024));
+        double full_utilization = this->totals.fullUsage * 100 / ((globalTime - sysOrch->getFirstStartTime()) * sysOrch->getArchitecture()->getNumberCPUs());
+        double full_utilization_mem = this->totals.fullUsageMem * 100 / ((globalTime - sysOrch->getFirstStartTime()) * sysOrch->getArchitecture()->getTotalMemory() / 1024 / 1024);
+        std::cout << std::endl << std::endl;
+        std::cout << "Total usage: " << this->totals.usage * 100 << std::endl;
+        std::cout << "Total Memory usage: " << this->totals.usageMem * 100 << std::endl;
+        std::cout << "Total full usage: " << this->totals.fullUsage * 100 << std::endl;
+        std::cout << "Total full Memory usage: " << this->totals.fullUsageMem * 100 << std::endl;
+        std::cout << "globalTime: " << (unsigned int) globalTime << std::endl;
+        std::cout << "SysOrch startTime: " << sysOrch->getFirstStartTime() << std::endl;
+        std::cout << "Number CPUs (sysOrch): " << sysOrch->getArchitecture()->getNumberCPUs() << std::endl;
+        std::cout << "Total Memory: " << (double) sysOrch->getArchitecture()->getTotalMemory() / 1024 / (double) 1024 << std::endl;
+
+        cout << endl << endl << "Total usage in cpus*s=" << ftos(this->totals.usage) << ", CPUs util percentage is:" << utilization << "%. Full utilization is: " << full_utilization << "%." << std::endl;
+        std::cout << "Total usage in mem*s=" << ftos(this->totals.usageMem) << ", Memory util percentage is: " << utilization_mem << "%. Full memory utilization is: " << full_utilization_mem << endl << endl;
+        std::cout << "Average Bounded slowdown: " << this->totals.slowdown / numberOfFinishedJobs << std::endl;
+        std::cout << "Average waiting time: " << this->totals.wait / numberOfFinishedJobs << std::endl;
+        std::cout << "Jobs to be scheduled: " << this->SimInfo->getWorkload()->JobList.size() << ". Jobs started: " << this->totals.startedJobs << ". Jobs finished: " << numberOfFinishedJobs << std::endl;
+        std::cout << "Event queue size: " << this->events->size() << std::endl;
+        std::cout << "Total number of jobs to be scheduled: " << this->SimInfo->getWorkload()->JobList.size() << endl;
+        std::cout << "Total number of jobs finished: " << numberOfFinishedJobs << endl;
+        std::cout << "Total number of backfilled jobs: " << backfillcounter << endl;
+        std::cout << "Event pool high-water mark: " << this->eventPool.getHighWaterMark() << " events in " << this->eventPool.getNumberOfSlabs() << " slabs" << endl;
+
+
+        this->collectFinalStatistics();
+        this->sysOrch->PostProcessScheduling();
+    }
+
+    /**
+     * Treats an event, that has to be the first one of the event queue, and releases it. The logical process of a
+     * partition passes the events to its partition instead of the system orchestrator.
+     * @param event The event to treat
+     */
+    void Simulation::treatEvent(SimulationEvent* event) {
+        this->currentEvent = event;
+        /* update the global to the current time for all the instances that use this time */
+        LOG_DEBUG(log, "GlobalTime = " + to_string(globalTime) + "  EventTime " + to_string(event->getTime()), 2);
+        assert(globalTime <= event->getTime());
+        this->globalTime = event->getTime();
+        if (this->partition != NULL)
+            this->partition->setGlobalTime(event->getTime());
+        else
             this->sysOrch->setGlobalTime(event->getTime());
-            Job* job = event->getJob();
-            this->currentJob = job;
-            if (log->getLevel() > 8)
-                this->dumpEvents();
-            //Create vars for the switch case
-            double rtime = 0, usage = 0, usage_mem = 0, full_usage = 0, full_usage_mem = 0;
-            //            double rtime, usage, usage_mem, terminationTime, full_usage, full_usage_mem;
-            int cpus;
-            double mem;
-            double maxbound;
-            double slowdown;
-
-            //		Partition *p;
-
-            /*we update the global time to the current event time .. */
-            switch (event->getType()) {
-                case EVENT_TERMINATION:
-                    log->debug("EVENT_TERMINATION for the job " + to_string(job->getJobNumber()), 2);
-                    log->debug("QUEUE LENGTH " + to_string(this->events.size()), 4);
-                    setJobPerformanceVariables(job);
+        Job* job = event->getJob();
+        this->currentJob = job;
+        if (log->getLevel() > 8)
+            this->dumpEvents();
+        //Create vars for the switch case
+        double rtime = 0, usage = 0, usage_mem = 0, full_usage = 0, full_usage_mem = 0;
+        //            double rtime, usage, usage_mem, terminationTime, full_usage, full_usage_mem;
+        int cpus;
+        double mem;
+        double maxbound;
+        double slowdown;
+
+        //		Partition *p;
+
+        /*we update the global time to the current event time .. */
+        switch (event->getType()) {
+            case EVENT_TERMINATION:
+                LOG_DEBUG(log, "EVENT_TERMINATION for the job " + to_string(job->getJobNumber()), 2);
+                LOG_DEBUG(log, "QUEUE LENGTH " + to_string(this->events->size()), 4);
+                setJobPerformanceVariables(job);
+                if (this->partition != NULL)
+                    this->partition->termination(job);
+                else
                     this->sysOrch->termination(job);
-                    //                    if (swfout != NULL) swfout->logJob(job);
-                    rtime = job->getRunTime();
-                    cpus = job->getNumberProcessors();
-                    mem = job->getRequestedMemory() / 1024 / 1024;
-                    usage = cpus*rtime;
-                    usage_mem = mem * cpus*rtime;
-                    maxbound = (job->getRunTime() < SlowdownBound) ? SlowdownBound : job->getRunTime();
-                    slowdown = (job->getJobSimWaitTime() + job->getRunTime()) / maxbound;
-                    total_slowdown += slowdown;
-                    total_wait += job->getJobSimWaitTime();
-                    job->setDelaySec(globalTime - (job->getJobSimSubmitTime() + job->getRunTime()));
-                    job->setArcherRatio(rtime / (rtime + job->getJobSimWaitTime()));
-                    total_usage += usage;
-                    total_usage_mem += usage_mem;
-                    full_total_usage += full_usage;
-                    full_total_usage_mem += full_usage_mem;
-                    terminatedJobs++;
-                    numberOfFinishedJobs++;
-                    break;
+                //                    if (swfout != NULL) swfout->logJob(job);
+                rtime = job->getRunTime();
+                cpus = job->getNumberProcessors();
+                mem = job->getRequestedMemory() / 1024 / 1024;
+                usage = cpus*rtime;
+                usage_mem = mem * cpus*rtime;
+                maxbound = (job->getRunTime() < SlowdownBound) ? SlowdownBound : job->getRunTime();
+                slowdown = (job->getJobSimWaitTime() + job->getRunTime()) / maxbound;
+                this->totals.slowdown += slowdown;
+                this->totals.wait += job->getJobSimWaitTime();
+                job->setDelaySec(globalTime - (job->getJobSimSubmitTime() + job->getRunTime()));
+                job->setArcherRatio(rtime / (rtime + job->getJobSimWaitTime()));
+                this->totals.usage += usage;
+                this->totals.usageMem += usage_mem;
+                this->totals.fullUsage += full_usage;
+                this->totals.fullUsageMem += full_usage_mem;
+                this->totals.terminatedJobs++;
+                numberOfFinishedJobs++;
+                break;
 
-                case EVENT_ABNORMAL_TERMINATION:
-                    log->debug("EVENT_ABNORMAL_TERMINATION for the job " + to_string(job->getJobNumber()), 2);
+            case EVENT_ABNORMAL_TERMINATION:
+                LOG_DEBUG(log, "EVENT_ABNORMAL_TERMINATION for the job " + to_string(job->getJobNumber()), 2);
+                if (this->partition != NULL)
+                    this->partition->termination(job);
+                else
                     sysOrch->abnormalTermination(job);
-                    setJobPerformanceVariables(job);
-                    break;
+                setJobPerformanceVariables(job);
+                break;
 
-                case EVENT_START:
-                    /* we just more the job from the wait queue to the runque
-                                    and also allocate the processes to the real processors
-                     */
-                    if (!getStartTimeFirstJob) {
-                        getStartTimeFirstJob = true;
-                        startTimeFirstJob = globalTime;
-                        // policy can play with this kind of data
+            case EVENT_START:
+                /* we just more the job from the wait queue to the runque
+                                and also allocate the processes to the real processors
+                 */
+                if (!this->firstJobStarted) {
+                    this->firstJobStarted = true;
+                    this->startTimeFirstJob = globalTime;
+                    // policy can play with this kind of data
+                    if (this->partition == NULL)
                         sysOrch->setFirstStartTime(startTimeFirstJob);
-                    }
-                    log->debug("EVENT_START for the job " + to_string(job->getJobNumber()), 2);
+                }
+                LOG_DEBUG(log, "EVENT_START for the job " + to_string(job->getJobNumber()), 2);
+                if (this->partition != NULL)
+                    this->partition->start(job);
+                else
                     sysOrch->start(job);
-                    startedJobs++;
-                    /* we also will show the progress information at this point */
-                    /* This should be replaced with something which just dumps a progress and a timestamp rather than scrolly text. */
-                    if (this->showSimulationProgress)
-                        showProgress(terminatedJobs, totalJobs);
-                    break;
+                this->totals.startedJobs++;
+                /* we also will show the progress information at this point */
+                /* This should be replaced with something which just dumps a progress and a timestamp rather than scrolly text. */
+                if (this->showSimulationProgress)
+                    showProgress(this->totals.terminatedJobs, this->SimInfo->getWorkload()->getLoadedJobs());
+                break;
 
-                case EVENT_ARRIVAL:
-                    log->debug("EVENT_ARRIVAL for the job " + to_string(job->getJobNumber()), 2);
-                    //cout << "Arrival of job " << job->getJobNumber()  << " at globaltime: " << this->globalTime << endl;
-                    /* first put the job to the wait queue and allocate it to the reservationTable */
+            case EVENT_ARRIVAL:
+                LOG_DEBUG(log, "EVENT_ARRIVAL for the job " + to_string(job->getJobNumber()), 2);
+                //cout << "Arrival of job " << job->getJobNumber()  << " at globaltime: " << this->globalTime << endl;
+                /* first put the job to the wait queue and allocate it to the reservationTable */
+                if (this->partition != NULL)
+                    this->partition->arrival(job);
+                else
                     sysOrch->arrival(job);
-                    break;
+                break;
 
-                case EVENT_COLLECT_STATISTICS:
-                    log->debug("EVENT_COLLECT_STATISTICS", 2);
-                    this->pendigStatsCollection--;
-                    //we generate and event for the next collection only if there is more than one event , coz in case there is one element in the event queue
-                    //will mean that this event is the collection event
-                    if (this->events.size() > 1 && pendigStatsCollection <= MAX_ALLOWED_STATSISTIC_EVENTS) {
-                        SimulationEvent* nextCollection = new SimulationEvent(EVENT_COLLECT_STATISTICS, 0, ++this->lastEventId, globalTime + this->collectStatisticsInterval);
-                        this->events.insert(nextCollection);
-                        this->pendigStatsCollection++;
-                    }
-                    if (lastEventType == EVENT_COLLECT_STATISTICS)
-                        ConsecutiveStatisticsCollection++;
-                    else
-                        ConsecutiveStatisticsCollection = 0;
-                    //we collect the current statistics
-                    if (ConsecutiveStatisticsCollection < 5)
-                        this->collectStatistics();
-                    break;
+            case EVENT_COLLECT_STATISTICS:
+                LOG_DEBUG(log, "EVENT_COLLECT_STATISTICS", 2);
+                this->pendigStatsCollection--;
+                //we generate and event for the next collection only if there is more than one event , coz in case there is one element in the event queue
+                //will mean that this event is the collection event
+                if (this->getNumberOfPendingEvents() + this->getPartitionPendingEvents() > 1 && pendigStatsCollection <= MAX_ALLOWED_STATSISTIC_EVENTS) {
+                    SimulationEvent* nextCollection = this->eventPool.newEvent(EVENT_COLLECT_STATISTICS, 0, ++this->lastEventId, globalTime + this->collectStatisticsInterval);
+                    this->queueEvent(nextCollection);
+                    this->pendigStatsCollection++;
+                }
+                if (lastEventType == EVENT_COLLECT_STATISTICS)
+                    this->consecutiveStatisticsCollection++;
+                else
+                    this->consecutiveStatisticsCollection = 0;
+                //we collect the current statistics
+                if (this->consecutiveStatisticsCollection < 5)
+                    this->collectStatistics();
+                break;
 
-                case EVENT_SCHEDULE:
-                    //                    cout << "Schedule from sysorch" << endl;
-                    log->debug("EVENT_SCHEDULE", 2);
+            case EVENT_SCHEDULE:
+                //                    cout << "Schedule from sysorch" << endl;
+                LOG_DEBUG(log, "EVENT_SCHEDULE", 2);
+                if (this->partition != NULL)
+                    this->partition->schedule();
+                else
                     sysOrch->schedule();
-                    break;
+                break;
 
-                case EVENT_BACKFILL:
-                    log->debug("EVENT_BACKFILL", 2);
+            case EVENT_BACKFILL:
+                LOG_DEBUG(log, "EVENT_BACKFILL", 2);
+                if (this->partition != NULL)
+                    this->partition->backfill();
+                else
                     sysOrch->backfill();
-                    break;
+                //the next cycle is only needed while something else can still happen, the statistics events do not count
+                if (this->backfillInterval > 0 && this->getNumberOfPendingEvents() > this->pendigStatsCollection) {
+                    SimulationEvent* nextBackfill = this->eventPool.newEvent(EVENT_BACKFILL, NULL, ++this->lastEventId, globalTime + this->backfillInterval);
+                    this->queueEvent(nextBackfill);
+                }
+                break;
 
-                case EVENT_TRANSITION_TO_COMPUTE:
-                    log->debug("EVENT_TRANSITION_TO_COMPUTE for the job " + to_string(job->getJobNumber()), 2);
+            case EVENT_TRANSITION_TO_COMPUTE:
+                LOG_DEBUG(log, "EVENT_TRANSITION_TO_COMPUTE for the job " + to_string(job->getJobNumber()), 2);
+                if (this->partition != NULL)
+                    this->partition->transitionToCompute(job);
+                else
                     sysOrch->transitiontoCompute(job);
-                    break;
+                break;
 
-                case EVENT_TRANSITION_TO_OUTPUT:
-                    log->debug("EVENT_TRANSITION_TO_OUTPUT for the job " + to_string(job->getJobNumber()), 2);
+            case EVENT_TRANSITION_TO_OUTPUT:
+                LOG_DEBUG(log, "EVENT_TRANSITION_TO_OUTPUT for the job " + to_string(job->getJobNumber()), 2);
+                if (this->partition != NULL)
+                    this->partition->transitionToOutput(job);
+                else
                     sysOrch->transitiontoOutput(job);
-                    break;
+                break;
 
-                default:
-                    log->debug("DEFAULT CASE", 1);
-                    assert(false);
-                    break;
+            default:
+                LOG_DEBUG(log, "DEFAULT CASE", 1);
+                assert(false);
+                break;
+        }
+        this->unqueueEvent(event);
+        lastEventType = event->getType();
+        this->eventPool.releaseEvent(event);
+        LOG_DEBUG(log, "EVENTS SIZE (after) " + to_string(this->events->size()), 4);
+        if (job != NULL)
+            /* this is only for debug stuff for check the last processed job in case of failure */
+            lastProcessedJob = job;
+    }
+
+    /**
+     * Splits the simulation in a logical process per partition, each one with its own event queue, that reads the arrivals
+     * of the jobs of its partition. The simulation starts at the first arrival of all of them. The partitions do not share nodes nor events, so the logical
+     * processes only have to wait for each other at the events that remain in the global queue, the statistics collections,
+     * and at the end of the lookahead windows (see runPartitionSimulations).
+     * They are not used when a partition could depend on another one or write to a shared output, then the simulation keeps
+     * a single event stream.
+     */
+    void Simulation::initPartitionSimulations() {
+        uint32_t numberOfPartitions = this->sysOrch->getNumberPartitions();
+        if (this->sysOrch->getPartitionPool() == NULL) {
+            log->error("The partitions need stores of their own, PartitionThreads greater than 1, to have their own event streams.");
+            return;
+        }
+        if (this->sysOrch->getOutputTrace()) {
+            log->error("The output trace is written in time order, the partitions cannot have their own event streams.");
+            return;
+        }
+        TraceFile* workload = this->SimInfo->getWorkload();
+        for (map<int, Job*>::iterator iter = workload->JobList.begin(); iter != workload->JobList.end(); ++iter) {
+            Job* job = iter->second;
+            for (vector<Job*>::iterator it = job->getSuccessors().begin(); it != job->getSuccessors().end(); ++it) {
+                if (this->sysOrch->getPartitionIndex(*it) != this->sysOrch->getPartitionIndex(job)) {
+                    log->error("The job " + to_string(job->getJobNumber()) + " has a succeeding job in another partition, the partitions cannot have their own event streams.");
+                    return;
+                }
             }
-            this->events.erase(iter);
-            lastEventType = event->getType();
-            delete event;
-            log->debug("EVENTS SIZE (after) " + to_string(this->events.size()), 4);
-            if (job != NULL)
-                /* this is only for debug stuff for check the last processed job in case of failure */
-                lastProcessedJob = job;
-        }
-        log->debug("Simulation has finished, we generate all the statistics and information for the analysis.", 1);
-        /*
-        double wtime = job->getJobSimWaitTime();
-        double rtime = job->getRunTime();
-        int cpus = job->getNumberProcessors();
-        double response = wtime + rtime;
+        }
 
-        double usage = cpus*rtime;
-         */
+        for (uint32_t i = 0; i < numberOfPartitions; i++) {
+            Simulation* partitionSimulation = new Simulation(this->SimInfo, this->log, this->sysOrch);
+            partitionSimulation->partition = this->sysOrch->getPartition(i);
+            partitionSimulation->setEventQueueType(this->eventQueueType);
+            partitionSimulation->SlowdownBound = this->SlowdownBound;
+            partitionSimulation->backfillInterval = this->backfillInterval;
+            partitionSimulation->collectStatisticsInterval = 0;
+            partitionSimulation->ArrivalFactor = this->ArrivalFactor;
+            partitionSimulation->lastEventId = this->lastEventId;
+            partitionSimulation->submitOrder = this->submitOrder;
+            partitionSimulation->nextListJob = workload->JobList.begin();
+            partitionSimulation->partition->setSim(partitionSimulation);
+            this->partitionSimulations.push_back(partitionSimulation);
+        }
+        //the partitions read the workload on their own
+        this->submitOrder.reset();
+
+        //we set the simulation start time to the first arrival of all the partitions
+        bool firstArrival = true;
+        for (uint32_t i = 0; i < numberOfPartitions; i++) {
+            Simulation* partitionSimulation = this->partitionSimulations[i];
+            partitionSimulation->nextArrival = partitionSimulation->readNextArrival();
+            if (partitionSimulation->nextArrival != NULL && (firstArrival || partitionSimulation->nextArrival->getJobSimSubmitTime() < this->globalTime)) {
+                this->globalTime = partitionSimulation->nextArrival->getJobSimSubmitTime();
+                firstArrival = false;
+            }
+        }
 
-        //TODO: IMPORTANT - redefine utilization
-        double utilization = total_usage * 100 / ((globalTime - sysOrch->getFirstStartTime()) * sysOrch->getArchitecture()->getNumberCPUs());
-        double utilization_mem = total_usage_mem * 100 / ((globalTime - sysOrch->getFirstStartTime())*(sysOrch->getArchitecture()->getTotalMemory() / 1024 / 1024));
-        double full_utilization = full_total_usage * 100 / ((globalTime - sysOrch->getFirstStartTime()) * sysOrch->getArchitecture()->getNumberCPUs());
-        double full_utilization_mem = full_total_usage_mem * 100 / ((globalTime - sysOrch->getFirstStartTime()) * sysOrch->getArchitecture()->getTotalMemory() / 1024 / 1024);
-        std::cout << std::endl << std::endl;
-        std::cout << "Total usage: " << total_usage * 100 << std::endl;
-        std::cout << "Total Memory usage: " << total_usage_mem * 100 << std::endl;
-        std::cout << "Total full usage: " << full_total_usage * 100 << std::endl;
-        std::cout << "Total full Memory usage: " << full_total_usage_mem * 100 << std::endl;
-        std::cout << "globalTime: " << (unsigned int) globalTime << std::endl;
-        std::cout << "SysOrch startTime: " << sysOrch->getFirstStartTime() << std::endl;
-        std::cout << "Number CPUs (sysOrch): " << sysOrch->getArchitecture()->getNumberCPUs() << std::endl;
-        std::cout << "Total Memory: " << (double) sysOrch->getArchitecture()->getTotalMemory() / 1024 / (double) 1024 << std::endl;
+        for (uint32_t i = 0; i < numberOfPartitions; i++) {
+            Simulation* partitionSimulation = this->partitionSimulations[i];
+            partitionSimulation->globalTime = this->globalTime;
+            //every partition runs its own backfill cycles
+            if (this->backfillInterval > 0)
+                partitionSimulation->queueEvent(partitionSimulation->eventPool.newEvent(EVENT_BACKFILL, NULL, ++partitionSimulation->lastEventId, this->globalTime + this->backfillInterval));
+        }
+        LOG_DEBUG(log, "The " + to_string(numberOfPartitions) + " partitions have their own event streams.", 1);
+    }
 
-        cout << endl << endl << "Total usage in cpus*s=" << ftos(total_usage) << ", CPUs util percentage is:" << utilization << "%. Full utilization is: " << full_utilization << "%." << std::endl;
-        std::cout << "Total usage in mem*s=" << ftos(total_usage_mem) << ", Memory util percentage is: " << utilization_mem << "%. Full memory utilization is: " << full_utilization_mem << endl << endl;
-        std::cout << "Average Bounded slowdown: " << total_slowdown / numberOfFinishedJobs << std::endl;
-        std::cout << "Average waiting time: " << total_wait / numberOfFinishedJobs << std::endl;
-        std::cout << "Jobs to be scheduled: " << this->SimInfo->getWorkload()->JobList.size() << ". Jobs started: " << startedJobs << ". Jobs finished: " << numberOfFinishedJobs << std::endl;
-        std::cout << "Event queue size: " << this->events.size() << std::endl;
-        std::cout << "Total number of jobs to be scheduled: " << this->SimInfo->getWorkload()->JobList.size() << endl;
-        std::cout << "Total number of jobs finished: " << numberOfFinishedJobs << endl;
-        std::cout << "Total number of backfilled jobs: " << backfillcounter << endl;
+    /**
+     * Treats the events of the logical process of a partition up to a given time. It stops after the event that it is
+     * treating when the process is asked to stop, the simulation that runs the partitions reports it.
+     * @param until The time of the last events to treat, -1 to treat all of them
+     * @return The number of events treated
+     */
+    size_t Simulation::advancePartition(double until) {
+        size_t treated = 0;
+        while (this->getNumberOfPendingEvents() > 0 && stopRequests == 0) {
+            this->injectArrivals();
+            SimulationEvent* event = this->events->top();
+            if (until >= 0 && event->getTime() > until)
+                break;
+            this->treatEvent(event);
+            treated++;
+        }
+        return treated;
+    }
 
+    /**
+     * Advances the logical process of a partition up to the next barrier in a thread of the pool
+     */
+    class PartitionAdvanceTask : public Utils::ThreadPoolTask {
+    public:
 
-        this->collectFinalStatistics();
-        this->sysOrch->PostProcessScheduling();
+        PartitionAdvanceTask(Simulation* partitionSimulation, double until) : partitionSimulation(partitionSimulation), until(until), treated(0) {
+        }
 
-        //TODO: Use computePower.
-        //if (policy->computePower())
-        /* print some information about power consumed during workload */
-        //policy->dumpGlobalPowerInformation(globalTime, usefull);
-        //Delete events objects
-        while (!events.empty()) {
-            SimulationEvent* foundEvent = *(events.begin());
-            events.erase(events.begin());
-            delete foundEvent;
+        void run() override {
+            this->treated = this->partitionSimulation->advancePartition(this->until);
         }
-        return true; //TODO: Return object
+
+        Simulation* partitionSimulation; /**< The logical process of the partition */
+        double until; /**< The time of the barrier, -1 if there is none */
+        size_t treated; /**< The number of events treated */
+    };
+
+    /**
+     * Runs the logical processes of the partitions. They advance at once up to a barrier, the end of a lookahead window that
+     * starts at the earliest event of all of them and lasts partitionLookahead seconds, or the next event of the global
+     * queue if it comes before. The global event is treated once all of them have reached it, so the statistics see the
+     * whole system at their time. With no lookahead and no global events left they run until they finish. At the end their
+     * totals are added to the ones of the simulation.
+     */
+    void Simulation::runPartitionSimulations() {
+        Utils::ThreadPool* pool = this->sysOrch->getPartitionPool();
+        while (continueSimulation()) {
+            //nothing happens in the partitions before the earliest of their events, the window starts there
+            double windowStart = -1;
+            for (uint32_t i = 0; i < this->partitionSimulations.size(); i++) {
+                double next = this->partitionSimulations[i]->getNextEventTime();
+                if (next >= 0 && (windowStart < 0 || next < windowStart))
+                    windowStart = next;
+            }
+            if (windowStart < 0 && this->events->empty())
+                break;
+            double barrier = (windowStart >= 0 && this->partitionLookahead > 0) ? windowStart + this->partitionLookahead : -1;
+            if (!this->events->empty() && (barrier < 0 || this->events->top()->getTime() <= barrier))
+                barrier = this->events->top()->getTime();
+
+            vector<PartitionAdvanceTask> tasks;
+            vector<Utils::ThreadPoolTask*> pending;
+            tasks.reserve(this->partitionSimulations.size());
+            for (uint32_t i = 0; i < this->partitionSimulations.size(); i++) {
+                tasks.push_back(PartitionAdvanceTask(this->partitionSimulations[i], barrier));
+                pending.push_back(&tasks.back());
+            }
+            pool->run(pending);
+
+            //the events of the partitions break the run of consecutive statistics collections
+            for (uint32_t i = 0; i < tasks.size(); i++)
+                if (tasks[i].treated > 0)
+                    this->lastEventType = EVENT_OTHER;
+            if (!this->events->empty() && this->events->top()->getTime() <= barrier)
+                this->treatEvent(this->events->top());
+        }
+
+        for (uint32_t i = 0; i < this->partitionSimulations.size(); i++) {
+            Simulation* partitionSimulation = this->partitionSimulations[i];
+            this->totals.usage += partitionSimulation->totals.usage;
+            this->totals.usageMem += partitionSimulation->totals.usageMem;
+            this->totals.fullUsage += partitionSimulation->totals.fullUsage;
+            this->totals.fullUsageMem += partitionSimulation->totals.fullUsageMem;
+            this->totals.slowdown += partitionSimulation->totals.slowdown;
+            this->totals.wait += partitionSimulation->totals.wait;
+            this->totals.terminatedJobs += partitionSimulation->totals.terminatedJobs;
+            this->totals.startedJobs += partitionSimulation->totals.startedJobs;
+            this->numberOfFinishedJobs += partitionSimulation->numberOfFinishedJobs;
+            this->backfillcounter += partitionSimulation->backfillcounter;
+            if (partitionSimulation->firstJobStarted && (!this->firstJobStarted || partitionSimulation->startTimeFirstJob < this->startTimeFirstJob)) {
+                this->firstJobStarted = true;
+                this->startTimeFirstJob = partitionSimulation->startTimeFirstJob;
+            }
+            if (partitionSimulation->globalTime > this->globalTime)
+                this->globalTime = partitionSimulation->globalTime;
+
+            partitionSimulation->partition->setSim(this);
+            while (!partitionSimulation->events->empty()) {
+                SimulationEvent* foundEvent = partitionSimulation->events->top();
+                partitionSimulation->unqueueEvent(foundEvent);
+                partitionSimulation->eventPool.releaseEvent(foundEvent);
+            }
+            delete partitionSimulation;
+        }
+        this->partitionSimulations.clear();
+        if (this->firstJobStarted)
+            this->sysOrch->setFirstStartTime(this->startTimeFirstJob);
+    }
+
+    /**
+     * Returns the number of events that the logical processes of the partitions have still to treat
+     * @return The number of pending events, 0 if the partitions do not have their own event streams
+     */
+    size_t Simulation::getPartitionPendingEvents() const {
+        size_t pending = 0;
+        for (uint32_t i = 0; i < this->partitionSimulations.size(); i++)
+            pending += this->partitionSimulations[i]->getNumberOfPendingEvents();
+        return pending;
+    }
+
+    /**
+     * Makes every partition run its own event stream in a logical process, see initPartitionSimulations. It must be called
+     * before the simulation is initialized.
+     * @param theValue True to split the simulation by partitions
+     */
+    void Simulation::setPartitionEventStreams(bool theValue) {
+        this->partitionEventStreams = theValue;
+    }
+
+    bool Simulation::getPartitionEventStreams() const {
+        return this->partitionEventStreams;
+    }
+
+    /**
+     * Sets the length of the lookahead windows of the logical processes of the partitions, see runPartitionSimulations.
+     * @param theValue The seconds of simulated time between two barriers, 0 to only stop at the global events
+     */
+    void Simulation::setPartitionLookahead(double theValue) {
+        assert(theValue >= 0);
+        this->partitionLookahead = theValue;
+    }
+
+    double Simulation::getPartitionLookahead() const {
+        return this->partitionLookahead;
+    }
+
+    /**
+     * Sets if the simulation shows its summary in the STDOUT and generates the statistics files when it finishes. The runs
+     * of a sweep do not, their results are collected in the CSV of the sweep.
+     * @param theValue True to report the results
+     */
+    void Simulation::setReportResults(bool theValue) {
+        this->reportResults = theValue;
+    }
+
+    bool Simulation::getReportResults() const {
+        return this->reportResults;
+    }
+
+    /**
+     * Returns the totals of the events treated so far
+     * @return A reference to the totals
+     */
+    const SimulationTotals& Simulation::getTotals() const {
+        return this->totals;
+    }
+
+    /**
+     * Returns the number of jobs that have finished so far
+     * @return The number of finished jobs
+     */
+    int Simulation::getNumberOfFinishedJobs() const {
+        return this->numberOfFinishedJobs;
     }
 
     /**
@@ -468,7 +723,7 @@ namespace Simulator {
     void Simulation::collectFinalStatistics() {
 
         if (numberOfFinishedJobs < 1) {
-            log->debug("No finished jobs. We do not compute the statistics.");
+            LOG_DEBUG(log, "No finished jobs. We do not compute the statistics.", 1);
             return;
         }
         SimStatistics* stats = this->SimInfo->getsimStatistics();
@@ -490,10 +745,36 @@ namespace Simulator {
      * @return A bool indicating if the simulation should be stopped 
      */
     bool Simulation::continueSimulation() {
+        //the signal handlers only leave the requests, they are served here between two events
+        if (stopRequests > 0 && !this->getStopSimulation()) {
+            std::printf("Terminating simulation a sigkill has been received...\n");
+            std::printf("All the statistic files and traces are being generated..\n");
+            this->setStopSimulation(true);
+        }
+        if (this->statisticsRequestsSeen != statisticsRequests) {
+            this->statisticsRequestsSeen = statisticsRequests;
+            this->showCurrentStatistics();
+        }
         bool continueSimulation = !this->getStopSimulation();
         return continueSimulation;
     }
 
+    /**
+     * Asks all the simulations of the process to stop after the event that they are treating. It only sets a flag, so it can
+     * be called from a signal handler.
+     */
+    void Simulation::requestStop() {
+        stopRequests = 1;
+    }
+
+    /**
+     * Asks all the simulations of the process to show their current statistics after the event that they are treating. It
+     * only sets a flag, so it can be called from a signal handler.
+     */
+    void Simulation::requestStatistics() {
+        statisticsRequests = statisticsRequests + 1;
+    }
+
     /**
      * Sets the paraver trace for the current simulation
      * @param trace A reference to the paraver trace 
@@ -523,67 +804,222 @@ namespace Simulator {
      * This function is mainly used for debugging or for state that the simulation is performing as expected. It will dump all the pending events to the debug engine.
      */
     void Simulation::dumpEvents() {
-        EventQueue::iterator it = this->events.begin(); // should be optimized !
-        for (; it != this->events.end(); ++it) {
+        if (this->log->getLevel() <= 8)
+            return;
+        vector<SimulationEvent*> pending = this->events->getOrderedEvents();
+        for (vector<SimulationEvent*>::iterator it = pending.begin(); it != pending.end(); ++it) {
             SimulationEvent* cEvent = *it;
             /* debug stuff */
-            if (this->log->getLevel() > 8 && (cEvent->getType() == EVENT_START || cEvent->getType() == EVENT_TERMINATION || cEvent->getType() == EVENT_TRANSITION_TO_OUTPUT || cEvent->getType() == EVENT_TRANSITION_TO_COMPUTE))
-                this->log->debug("Event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled for " + ftos(cEvent->getTime()) + " for the job " + to_string(cEvent->getJob()->getJobNumber()), 2);
+            if (cEvent->getType() == EVENT_START || cEvent->getType() == EVENT_TERMINATION || cEvent->getType() == EVENT_TRANSITION_TO_OUTPUT || cEvent->getType() == EVENT_TRANSITION_TO_COMPUTE)
+                LOG_DEBUG(this->log, "Event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled for " + ftos(cEvent->getTime()) + " for the job " + to_string(cEvent->getJob()->getJobNumber()), 2);
         }
     }
 
     /**
-     * Delete all the events that concerns the provided job. This is used in situations when the job has been rescheduled and the events that was previously generated have lost its validity.
-     * @param job The job to whom events have to be deleted 
+     * Inserts an event in the event queue. If the event concerns a job, the job keeps a handle to it so it can be found without searching the queue.
+     * @param event The event to be inserted
      */
-    void Simulation::deleteJobEvents(Job* job) {
-        vector<SimulationEvent*> toDelete;
-        EventQueue::iterator it = this->events.begin(); // should be optimized !
-        log->debug("Deleting events for job " + to_string(job->getJobNumber()), 2);
-        dumpEvents();
+    void Simulation::queueEvent(SimulationEvent* event) {
+        this->events->insert(event);
+        if (event->getJob() != NULL)
+            event->getJob()->addPendingEvent(event);
+    }
 
-        for (; it != this->events.end(); ++it) {
+    /**
+     * Removes an event from the event queue and from the handles of its job. The event is not deleted.
+     * @param event The event to be removed
+     */
+    void Simulation::unqueueEvent(SimulationEvent* event) {
+        this->events->erase(event);
+        if (event->getJob() != NULL)
+            event->getJob()->removePendingEvent(event);
+    }
 
-            SimulationEvent* cEvent = *it;
-            /* debug stuff */
-            if (this->log->getLevel() > 8 && (cEvent->getType() == EVENT_START || cEvent->getType() == EVENT_TERMINATION)) {
-                this->log->debug("Event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled by " + ftos(cEvent->getTime()) + " for the job " + to_string(cEvent->getJob()->getJobNumber()), 2);
+    /**
+     * Prepares the reading of the arrivals of the workload. The job list is ordered by job number, which in the traces is
+     * the submit order, so it is read in place and the arrival events are only created when their batch is the next one to
+     * be treated. A single pass checks the order, a workload that is not in submit order, for instance after moving its
+     * arrivals, is sorted once in a vector of jobs. The arrival and schedule events of the workload take the ids below the
+     * ones of the rest of events, so they are treated in the same order as when they were all queued before the simulation.
+     */
+    void Simulation::initArrivals() {
+        TraceFile* workload = this->SimInfo->getWorkload();
+        double previousSubmitTime = -1;
+        for (map<int, Job*>::iterator iter = workload->JobList.begin(); iter != workload->JobList.end(); ++iter) {
+            Job* job = iter->second;
+            if (job->getRunTime() == 0)
+                continue;
+            if (job->getJobSimSubmitTime() < previousSubmitTime) {
+                LOG_DEBUG(log, "The job " + to_string(job->getJobNumber()) + " arrives before the previous one, the workload is sorted by submit time", 1);
+                this->submitOrder = make_shared< vector<Job*> >();
+                this->submitOrder->reserve(workload->JobList.size());
+                for (map<int, Job*>::iterator it = workload->JobList.begin(); it != workload->JobList.end(); ++it)
+                    this->submitOrder->push_back(it->second);
+                //the jobs with the same submit time keep the order of their numbers
+                stable_sort(this->submitOrder->begin(), this->submitOrder->end(), [](Job* job1, Job* job2) {
+                    return job1->getJobSimSubmitTime() < job2->getJobSimSubmitTime();
+                });
+                break;
             }
+            previousSubmitTime = job->getJobSimSubmitTime();
+        }
+        this->nextListJob = workload->JobList.begin();
+        this->nextOrderedJob = 0;
+        this->nextArrival = NULL;
+        this->nextArrivalId = 0;
+        //every job has at most an arrival and a schedule event, and there is a last schedule event
+        this->lastEventId += 2 * workload->JobList.size() + 1;
+    }
 
+    /**
+     * Decides if a job of the workload arrives to this simulation. The jobs with runtime zero are skipped and the jobs that use
+     * more processors than the system has are killed. The logical process of a partition only admits the jobs of its partition.
+     * The arrival factor is applied to the submit time of the job.
+     * @param job The job
+     * @return True if the job has to arrive
+     */
+    bool Simulation::admitArrival(Job* job) {
+        if (this->partition != NULL && this->sysOrch->getPartition(this->sysOrch->getPartitionIndex(job)) != this->partition)
+            return false;
 
+        /*
+         * If a job has a runtime of zero, we don;t bother with it.
+         */
+        if (job->getRunTime() == 0) {
+            LOG_DEBUG(log, "The job " + to_string(job->getJobNumber()) + " has runtime zero, we skip it", 2);
+            return false;
+        }
 
-            // SCHEDULE events don't have an associated job, so don't try to print it!
-            // Plus, we skip excessive SCHEDULEs in quick succession, so no need to worry about them wasting resource.
-            //            if (this->log->getLevel() > 8 && (cEvent->getType() == EVENT_SCHEDULE)) {
-            //                this->log->debug("GlobalTime[" + to_string(globalTime) + "]" + "Event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled by " + ftos(cEvent->getTime())  + " for the job " + itos( cEvent->getJob()->getJobNumber() ), 2);
-            //            }
+        /*
+         * Generally, we use ArrivalFactor of 1, ie no tampering with time.
+         */
+        job->setJobSimSubmitTime(ceil(job->getJobSimSubmitTime() * this->ArrivalFactor));
 
-            if ((cEvent->getType() == EVENT_START || cEvent->getType() == EVENT_TERMINATION || cEvent->getType() == EVENT_TRANSITION_TO_COMPUTE || cEvent->getType() == EVENT_TRANSITION_TO_OUTPUT) && cEvent->getJob()->getJobNumber() == job->getJobNumber() && currentEvent->getid() != cEvent->getid()) {
-                this->log->debug("Deleting the event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled by " + ftos(cEvent->getTime()) + " for the job " + to_string(cEvent->getJob()->getJobNumber()), 2);
-                toDelete.push_back(cEvent);
-                continue;
-            }
+        /*
+         * This part quickly checks to see if any jobs uses more CPUs than exists in the system.
+         * If so, the jobs doesn't ARRIVE, and is dropped.
+         */
+        if ((this->SimInfo->getarchConfiguration() == 0 || job->getNumberProcessors() <= (int) this->SimInfo->getarchConfiguration()->getNumberCPUs()) && job->getNumberProcessors() != -1)
+            return true;
+        job->setJobSimStatus(KILLED_NOT_ENOUGH_RESOURCES);
+        log->error("The job " + to_string(job->getJobNumber()) + " uses " + to_string(job->getNumberProcessors()) + " and the architecture has fewer processors.");
+        return false;
+    }
 
-            //            if (cEvent->getType() != EVENT_COLLECT_STATISTICS && cEvent->getType() != EVENT_SCHEDULE && cEvent->getJob()->getJobNumber() == job->getJobNumber() && currentEvent->getid() != cEvent->getid()) {
-            //                log->debug("dsdfsdfsf", 2);
-            //                //this->log->debug("GlobalTime[" + to_string(globalTime) + "]" + "Deleting the event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled by " + ftos(cEvent->getTime()) + " for the job " + to_string(cEvent->getJob()->getJobNumber()), 2);
-            //                toDelete.push_back(cEvent);
-            //                continue;
-            //            }
+    /**
+     * Reads the next job that arrives to this simulation, in submit time order and, at the same time, in job number order
+     * @return The job, NULL if the whole workload has been read
+     */
+    Job* Simulation::readNextArrival() {
+        TraceFile* workload = this->SimInfo->getWorkload();
+        while (true) {
+            Job* job;
+            if (this->submitOrder) {
+                if (this->nextOrderedJob == this->submitOrder->size())
+                    return NULL;
+                job = (*this->submitOrder)[this->nextOrderedJob++];
+            } else {
+                if (this->nextListJob == workload->JobList.end())
+                    return NULL;
+                job = (this->nextListJob++)->second;
+            }
+            if (this->admitArrival(job))
+                return job;
+        }
+    }
 
-            //            /* debug stuff */
-            //            if (this->log->getLevel() > 8 && (cEvent->getType() == EVENT_START || cEvent->getType() == EVENT_TERMINATION)){
-            //                this->log->debug("GlobalTime[" + to_string(globalTime) + "]" + "Event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled by " + ftos(cEvent->getTime()) + " for the job " + to_string(cEvent->getJob()->getJobNumber()), 2);
-            //            }
+    /**
+     * Queues the next batch of arrivals, the jobs that share the submit time of the next job to arrive, and the schedule event
+     * of their time. After the last batch a second schedule event is queued, as the simulation always did. Nothing is done
+     * while the head of the event queue goes before the next arrival, so the queue only holds the jobs that are in flight
+     * and the events of the workload are only created when they are about to be treated.
+     */
+    void Simulation::injectArrivals() {
+        if (this->nextArrival == NULL)
+            return;
+        double batchTime = this->nextArrival->getJobSimSubmitTime();
+        eventorder_t before;
+        SimulationEvent arrival(EVENT_ARRIVAL, this->nextArrival, this->nextArrivalId + 1, batchTime);
+        if (!this->events->empty() && before(this->events->top(), &arrival))
+            return;
+        while (this->nextArrival != NULL && this->nextArrival->getJobSimSubmitTime() == batchTime) {
+            this->queueEvent(this->eventPool.newEvent(EVENT_ARRIVAL, this->nextArrival, ++this->nextArrivalId, batchTime));
+            LOG_DEBUG(log, "Adding an EVENT_ARRIVAL event for the job " + to_string(this->nextArrival->getJobNumber()) + " the event id is " + to_string(this->nextArrivalId) + " the time for the event is " + ftos(batchTime), 1);
+            this->nextArrival = this->readNextArrival();
+        }
+        /*
+         * A single scheduling event covers all the jobs that arrive at exactly the same time.
+         */
+        this->queueEvent(this->eventPool.newEvent(EVENT_SCHEDULE, NULL, ++this->nextArrivalId, batchTime));
+        LOG_DEBUG(log, "Adding an EVENT_SCHEDULE event for the arrivals, the event id is " + to_string(this->nextArrivalId) + " the time for the event is " + ftos(batchTime), 1);
+        if (this->nextArrival == NULL) {
+            this->queueEvent(this->eventPool.newEvent(EVENT_SCHEDULE, NULL, ++this->nextArrivalId, batchTime));
+            LOG_DEBUG(log, "Adding an EVENT_SCHEDULE event for the LAST job the event id is " + to_string(this->nextArrivalId) + " the time for the event is " + ftos(batchTime), 1);
+            //the workload has been read, we release the sorted jobs
+            this->submitOrder.reset();
         }
+    }
 
+    /**
+     * Returns the number of events that are still to be treated. The arrivals that have not been read yet count as a single
+     * event, the callers only compare it against the events they already know of.
+     * @return The number of pending events
+     */
+    size_t Simulation::getNumberOfPendingEvents() const {
+        return this->events->size() + (this->nextArrival != NULL ? 1 : 0);
+    }
 
+    /**
+     * Returns the time of the next event to treat, the arrivals that have not been read yet included
+     * @return The time of the next event, -1 if there are no pending events
+     */
+    double Simulation::getNextEventTime() const {
+        double next = this->events->empty() ? -1 : this->events->top()->getTime();
+        if (this->nextArrival != NULL && (next < 0 || this->nextArrival->getJobSimSubmitTime() < next))
+            next = this->nextArrival->getJobSimSubmitTime();
+        return next;
+    }
+
+    /**
+     * Returns the pending termination event of the job that will be triggered first.
+     * @param job The job whose termination is looked for
+     * @return The termination event, NULL if the job has no pending termination (the event being treated is not considered)
+     */
+    SimulationEvent* Simulation::findJobFinishEvent(Job* job) {
+        SimulationEvent* found = NULL;
+        eventorder_t before;
+        vector<SimulationEvent*>& pending = job->getPendingEvents();
+        for (vector<SimulationEvent*>::iterator it = pending.begin(); it != pending.end(); ++it) {
+            SimulationEvent* cEvent = *it;
+            if ((cEvent->getType() == EVENT_TERMINATION || cEvent->getType() == EVENT_ABNORMAL_TERMINATION) && cEvent != this->currentEvent
+                    && (found == NULL || before(cEvent, found)))
+                found = cEvent;
+        }
+        return found;
+    }
+
+    /**
+     * Delete all the events that concerns the provided job. This is used in situations when the job has been rescheduled and the events that was previously generated have lost its validity.
+     * @param job The job to whom events have to be deleted 
+     */
+    void Simulation::deleteJobEvents(Job* job) {
+        if (deferredEvents != NULL) {
+            DeferredEvent deferred = {DEFERRED_DELETE_JOB_EVENTS, EVENT_ILLEGAL, job, 0};
+            deferredEvents->push_back(deferred);
+            return;
+        }
+        LOG_DEBUG(log, "Deleting events for job " + to_string(job->getJobNumber()), 2);
+        dumpEvents();
 
-        for (vector<SimulationEvent*>::iterator itdel = toDelete.begin(); itdel != toDelete.end(); ++itdel) {
-            SimulationEvent* ev = *itdel;
-            EventQueue::iterator it = this->events.find(ev); // should be optimized !
-            assert(it != this->events.end());
-            this->events.erase(it);
+        //we iterate over a copy, unqueueing an event modifies the handles of the job
+        vector<SimulationEvent*> pending(job->getPendingEvents());
+        for (vector<SimulationEvent*>::iterator it = pending.begin(); it != pending.end(); ++it) {
+            SimulationEvent* cEvent = *it;
+            if ((cEvent->getType() == EVENT_START || cEvent->getType() == EVENT_TERMINATION || cEvent->getType() == EVENT_TRANSITION_TO_COMPUTE || cEvent->getType() == EVENT_TRANSITION_TO_OUTPUT) && cEvent != this->currentEvent) {
+                LOG_DEBUG(this->log, "Deleting the event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled by " + ftos(cEvent->getTime()) + " for the job " + to_string(job->getJobNumber()), 2);
+                this->unqueueEvent(cEvent);
+                this->eventPool.releaseEvent(cEvent);
+            }
         }
     }
 
@@ -594,18 +1030,12 @@ namespace Simulator {
     void Simulation::deleteJobFinishEvent(Job* job) {
         if (job == this->currentJob && this->currentEvent->getType() == EVENT_ARRIVAL)
             return;
-        EventQueue::iterator it = this->events.begin(); // should be optimized !
-        for (; it != this->events.end(); ++it) {
-            SimulationEvent* cEvent = *it;
-            if (cEvent->getType() != EVENT_COLLECT_STATISTICS && cEvent->getJob()->getJobNumber() == job->getJobNumber() && currentEvent->getid() != cEvent->getid()
-                    && (cEvent->getType() == EVENT_TERMINATION || cEvent->getType() == EVENT_ABNORMAL_TERMINATION)
-                    ) {
-                this->log->debug("Deleting the event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled by " + ftos(cEvent->getTime()) + " for the job " + to_string(cEvent->getJob()->getJobNumber()), 2);
-                this->events.erase(it);
-                delete cEvent;
-                //we can return due to there should not be more than one event termination per jobs
-                return;
-            }
+        SimulationEvent* cEvent = this->findJobFinishEvent(job);
+        //there should not be more than one event termination per jobs
+        if (cEvent != NULL) {
+            LOG_DEBUG(this->log, "Deleting the event type " + to_string(cEvent->getType()) + " with the id " + to_string(cEvent->getid()) + " that is scheduled by " + ftos(cEvent->getTime()) + " for the job " + to_string(job->getJobNumber()), 2);
+            this->unqueueEvent(cEvent);
+            this->eventPool.releaseEvent(cEvent);
         }
     }
 
@@ -624,7 +1054,7 @@ namespace Simulator {
          * Search for note EVENT_TERMINATION_NOTE1 in this same document.
          */
         if (!(job == this->currentJob && this->currentEvent->getType() == EVENT_START)) {
-            log->debug("Rescheduling the job " + to_string(job->getJobNumber()) + ". Adding an EVENT_TERMINATE " + ftos(endTime), 2);
+            LOG_DEBUG(log, "Rescheduling the job " + to_string(job->getJobNumber()) + ". Adding an EVENT_TERMINATE " + ftos(endTime), 2);
             /*we create a job termination for the job .. if it fails, or must be killed*/
             SimulationEvent* finishjob = NULL;
             double terminationTime = -1;
@@ -636,13 +1066,13 @@ namespace Simulator {
             //else
             terminationTime = job->getJobSimStartTime() + job->getOriginalRequestedTime();
             if (job->getStatus() == COMPLETED) {
-                finishjob = new SimulationEvent(EVENT_TERMINATION, job, ++this->lastEventId, terminationTime);
-                log->debug("Adding an EVENT_TERMINATION event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(endTime), 2);
+                finishjob = this->eventPool.newEvent(EVENT_TERMINATION, job, ++this->lastEventId, terminationTime);
+                LOG_DEBUG(log, "Adding an EVENT_TERMINATION event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(endTime), 2);
             } else {
-                finishjob = new SimulationEvent(EVENT_ABNORMAL_TERMINATION, job, ++this->lastEventId, terminationTime);
-                log->debug("Adding an EVENT_ABNORMAL_TERMINATION event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(endTime), 2);
+                finishjob = this->eventPool.newEvent(EVENT_ABNORMAL_TERMINATION, job, ++this->lastEventId, terminationTime);
+                LOG_DEBUG(log, "Adding an EVENT_ABNORMAL_TERMINATION event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(endTime), 2);
             }
-            this->events.insert(finishjob);
+            this->queueEvent(finishjob);
         }
         //debugging stuff
         if (this->log->getLevel() > 8)
@@ -663,19 +1093,19 @@ namespace Simulator {
         //create any EVENT TERMINATION due to this events will be created in the main doSimulation method
         if (!(job == this->currentJob && this->currentEvent->getType() == EVENT_ARRIVAL)) {
             /*create  event for the job start*/
-            SimulationEvent* startjob = new SimulationEvent(EVENT_START, job, ++this->lastEventId, startTime);
+            SimulationEvent* startjob = this->eventPool.newEvent(EVENT_START, job, ++this->lastEventId, startTime);
             /*we create a job termination for the job .. if it fails, or must be killed*/
             SimulationEvent* finishjob = NULL;
-            log->debug("Rescheduling the job " + to_string(job->getJobNumber()) + ". Adding an EVENT_START  the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(startTime), 2);
+            LOG_DEBUG(log, "Rescheduling the job " + to_string(job->getJobNumber()) + ". Adding an EVENT_START  the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(startTime), 2);
             if (job->getStatus() == COMPLETED) {
-                finishjob = new SimulationEvent(EVENT_TERMINATION, job, ++this->lastEventId, endTime);
-                log->debug("Adding an EVENT_TERMINATION event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(endTime), 2);
+                finishjob = this->eventPool.newEvent(EVENT_TERMINATION, job, ++this->lastEventId, endTime);
+                LOG_DEBUG(log, "Adding an EVENT_TERMINATION event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(endTime), 2);
             } else {
-                finishjob = new SimulationEvent(EVENT_ABNORMAL_TERMINATION, job, ++this->lastEventId, endTime);
-                log->debug("Adding an EVENT_ABNORMAL_TERMINATION event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(endTime), 2);
+                finishjob = this->eventPool.newEvent(EVENT_ABNORMAL_TERMINATION, job, ++this->lastEventId, endTime);
+                LOG_DEBUG(log, "Adding an EVENT_ABNORMAL_TERMINATION event for the job " + to_string(job->getJobNumber()) + " the event id is " + to_string(this->lastEventId) + " the time for the event is " + ftos(endTime), 2);
             }
-            this->events.insert(startjob);
-            this->events.insert(finishjob);
+            this->queueEvent(startjob);
+            this->queueEvent(finishjob);
         }
         //debugging stuff
         if (this->log->getLevel() > 8)
@@ -751,6 +1181,22 @@ namespace Simulator {
         collectStatisticsInterval = theValue;
     }
 
+    /**
+     * Returns the period of the backfill cycles
+     * @return A double containing the interval between two backfill cycles, 0 if there are no cycles
+     */
+    double Simulation::getBackfillInterval() const {
+        return backfillInterval;
+    }
+
+    /**
+     * Sets the period of the backfill cycles, the bf_interval of SLURM
+     * @param theValue The interval between two backfill cycles, 0 for no cycles
+     */
+    void Simulation::setBackfillInterval(double theValue) {
+        backfillInterval = theValue;
+    }
+
     /**
      * Invoqued when the statistics event is raised. 
      */
@@ -856,8 +1302,7 @@ namespace Simulator {
      * Sets a job start event
      */
     void Simulation::simInsertJobStartEvent(Job *job) {
-        SimulationEvent* startjob = new SimulationEvent(EVENT_START, job, ++this->lastEventId, job->getJobSimStartTime());
-        this->events.insert(startjob);
+        this->insertEvent(EVENT_START, job, job->getJobSimStartTime());
         return;
     }
 
@@ -865,41 +1310,52 @@ namespace Simulator {
      * Sets a job finish event
      */
     void Simulation::simInsertJobFinishEvent(Job *job) {
-        SimulationEvent* finishjob = new SimulationEvent(EVENT_TERMINATION, job, ++this->lastEventId, job->getJobSimFinishTime());
-        this->events.insert(finishjob);
+        this->insertEvent(EVENT_TERMINATION, job, job->getJobSimFinishTime());
         return;
     }
 
+    /**
+     * Moves the finish event of the job to its current finish time, in O(log n). The event takes a new id, as if it had been deleted and created again.
+     */
     void Simulation::simModifyJobFinishEvent(Job *job) {
-        // First delete old finish event
-        EventQueue::iterator it = this->events.begin(); // should be optimized !
-        for (; it != this->events.end(); ++it) {
-            SimulationEvent* cEvent = *it;
-            if ((cEvent->getJob() != NULL) && (cEvent->getJob()->getJobNumber() == job->getJobNumber()) && (cEvent->getType() == EVENT_TERMINATION || cEvent->getType() == EVENT_ABNORMAL_TERMINATION)) {
-                this->events.erase(it);
-                delete cEvent;
-                break;
-            }
+        if (deferredEvents != NULL) {
+            DeferredEvent deferred = {DEFERRED_MODIFY_FINISH, EVENT_TERMINATION, job, job->getJobSimFinishTime()};
+            deferredEvents->push_back(deferred);
+            return;
         }
+        this->modifyJobFinishEvent(job, job->getJobSimFinishTime());
+    }
 
-        // Now add the new event
-        SimulationEvent* finishjob = new SimulationEvent(EVENT_TERMINATION, job, ++this->lastEventId, job->getJobSimFinishTime());
-        this->events.insert(finishjob);
+    /**
+     * Moves the finish event of the job to a given time, or inserts it if the job has none.
+     * @param job The job
+     * @param time The new finish time
+     */
+    void Simulation::modifyJobFinishEvent(Job* job, double time) {
+        SimulationEvent* finishjob = this->findJobFinishEvent(job);
+        if (finishjob == NULL) {
+            this->insertEvent(EVENT_TERMINATION, job, time);
+            return;
+        }
+        //the event is taken out while it is modified, the queues rely on the time and id of the queued events
+        this->events->erase(finishjob);
+        finishjob->setType(EVENT_TERMINATION);
+        finishjob->setId(++this->lastEventId);
+        finishjob->setTime(time);
+        this->events->insert(finishjob);
         return;
     }
 
     void Simulation::simInsertScheduleEvent() {
-        SimulationEvent* scheduleevent = new SimulationEvent(EVENT_SCHEDULE, NULL, ++this->lastEventId, this->globalTime);
-        this->events.insert(scheduleevent);
+        this->insertEvent(EVENT_SCHEDULE, NULL, this->globalTime);
     }
 
     void Simulation::simInsertComputeBeginEvent(Job *job) {
         double _temp = job->getIOCompRatio();
         _temp *= job->getRunTime();
         _temp += job->getJobSimStartTime();
-        SimulationEvent* scheduleevent = new SimulationEvent(EVENT_TRANSITION_TO_COMPUTE, job, ++this->lastEventId, int(_temp));
         //        log->debug("Inserting TRANS TO COMPUTE for job " + std::to_string(job->getJobNumber()) + " at " + std::to_string(int(_temp)), 2);
-        this->events.insert(scheduleevent);
+        this->insertEvent(EVENT_TRANSITION_TO_COMPUTE, job, int(_temp));
 
     }
 
@@ -907,9 +1363,55 @@ namespace Simulator {
         double _temp = 1.0 - job->getIOCompRatio();
         _temp *= job->getRunTime();
         _temp += job->getJobSimStartTime();
-        SimulationEvent* scheduleevent = new SimulationEvent(EVENT_TRANSITION_TO_OUTPUT, job, ++this->lastEventId, _temp);
-        this->events.insert(scheduleevent);
+        this->insertEvent(EVENT_TRANSITION_TO_OUTPUT, job, _temp);
+
+    }
+
+    /**
+     * Creates an event and queues it, unless the event operations of the current thread are deferred, then it is only recorded.
+     * @param type The type of the event
+     * @param job The job of the event, NULL if it has none
+     * @param time The time of the event
+     */
+    void Simulation::insertEvent(event_t type, Job* job, double time) {
+        if (deferredEvents != NULL) {
+            DeferredEvent deferred = {DEFERRED_INSERT, type, job, time};
+            deferredEvents->push_back(deferred);
+            return;
+        }
+        SimulationEvent* event = this->eventPool.newEvent(type, job, ++this->lastEventId, time);
+        this->queueEvent(event);
+    }
+
+    /**
+     * Makes the event operations requested from the calling thread go to a buffer instead of the event queue, so policies
+     * can run in other threads. The event queue and the event pool are only touched when the buffer is applied.
+     * @param buffer Where the operations are recorded, in order, or NULL to apply them at once again
+     */
+    void Simulation::deferEvents(vector<DeferredEvent>* buffer) {
+        deferredEvents = buffer;
+    }
 
+    /**
+     * Applies the event operations recorded in a buffer, in the order they were requested. It has to be called from a thread
+     * whose operations are not deferred.
+     * @param buffer The operations
+     */
+    void Simulation::applyDeferredEvents(const vector<DeferredEvent>& buffer) {
+        assert(deferredEvents == NULL);
+        for (vector<DeferredEvent>::const_iterator it = buffer.begin(); it != buffer.end(); ++it) {
+            switch (it->operation) {
+                case DEFERRED_INSERT:
+                    this->insertEvent(it->type, it->job, it->time);
+                    break;
+                case DEFERRED_MODIFY_FINISH:
+                    this->modifyJobFinishEvent(it->job, it->time);
+                    break;
+                case DEFERRED_DELETE_JOB_EVENTS:
+                    this->deleteJobEvents(it->job);
+                    break;
+            }
+        }
     }
 
     SimulatorCharacteristics* Simulation::getSimInfo() {
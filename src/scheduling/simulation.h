@@ -26,6 +26,9 @@
 #include <scheduling/schedulingpolicy.h>
 #include <scheduling/simulatorcharacteristics.h>
 #include <scheduling/simulationevent.h>
+#include <scheduling/heapeventqueue.h>
+#include <scheduling/calendareventqueue.h>
+#include <scheduling/eventpool.h>
 #include <scheduling/reservationtable.h>
 #include <utils/log.h>
 #include <utils/paravertrace.h>
@@ -34,6 +37,9 @@
 #include <utils/csvpolicyinfoconverter.h>
 #include <scheduling/powerconsumption.h>
 #include <scheduling/swftracefile.h>
+#include <atomic>
+#include <csignal>
+#include <memory>
 #include <set>
 
 using namespace std;
@@ -42,75 +48,45 @@ using std::set;
 
 namespace Simulator {
 
+    //Forward declaration
+    class Partition;
+
+    /** The operations on the event queue that can be deferred */
+    enum deferred_operation_t {
+        DEFERRED_INSERT = 0, /**< Inserts a new event */
+        DEFERRED_MODIFY_FINISH, /**< Moves the finish event of the job */
+        DEFERRED_DELETE_JOB_EVENTS /**< Deletes the pending events of the job */
+    };
+
     /**
-     * @author Francesc Guim,C6-E201,93 401 16 50,
+     * An operation on the event queue requested by a policy while the partitions are scheduled at once. The event is not
+     * created until the operation is applied, so the events get the same ids as when the partitions are scheduled one after the other.
      */
+    struct DeferredEvent {
+        deferred_operation_t operation; /**< The operation */
+        event_t type; /**< The type of the event to insert */
+        Job* job; /**< The job of the event, NULL if it has none */
+        double time; /**< The time of the event to insert or the new finish time */
+    };
 
-    /** Struct that contains the lessthan operator that is used in the EventQueue type. The jobs are ordered by its time, and in case equal time, the events are ordered by its ide   */
-    struct eventorder_t {
-
-        bool operator()(SimulationEvent* event1, SimulationEvent* event2) const {
-
-            /*
-             * TRUE means event 1 goes closer to the head of the queue
-             * FALSE means event 2 goes closer to the head of the queue
-             */
-
-            volatile double e1time = event1->getTime();
-            volatile double e2time = event2->getTime();
-            assert(e1time >= 0 && e2time >= 0);
-
-            /* 
-             * Simple case, if event 1 occurs before event 2.
-             */
-            if (e1time < e2time)
-                return true;
-
-            /* 
-             * Simple case, if event 2 occurs before event 1.
-             */
-
-            if (e2time < e1time)
-                return false;
-
-            /*
-             * Complex case, if both events occur at the same time.
-             * We have to rank on priority according to event type, with SCHEDULE always being the loser.
-             */
-            if (e1time == e2time) {
-                if (event1->getType() == EVENT_SCHEDULE && event2->getType() != EVENT_SCHEDULE) {
-                    return false;
-                } else if (event1->getType() != EVENT_SCHEDULE && event2->getType() == EVENT_SCHEDULE) {
-                    return true;
-                } else {
-                    return event1->getid() < event2->getid();
-                }
-            }
-
-            //else if( (event1->getType() == EVENT_START) && (event2->getType() == EVENT_START))
-            //	return false;
-            //else if( event1->getType() == EVENT_START ) {
-            //		return true;
-            //}
-
-            //	return true;
-            //else if( event2->getType() == EVENT_START )
-            //	return true;
-            //	else if(event1->getType() == EVENT_TERMINATION && event2->getType() == EVENT_ARRIVAL)
-            /* in case that two events occurs at the same time, we priorize the jobs that free processors as Dan in SimEasy*/
-            //	   return true;
-            //	else if (event1->getType() == EVENT_ARRIVAL && event2->getType() == EVENT_START)
-            /* in case that two events occurs at the same time, we priorize the event that is a event arrival due to is preferable to schedule again*/
-            //	   return true;
-
-            // If we don't know, just pick event 1.
-            return true;
+    /** The totals accumulated by a simulation over the treated events */
+    struct SimulationTotals {
+        double usage; /**< The processor time used by the finished jobs */
+        double usageMem; /**< The memory time used by the finished jobs */
+        double fullUsage; /**< The processor time of the full nodes used by the finished jobs */
+        double fullUsageMem; /**< The memory time of the full nodes used by the finished jobs */
+        double slowdown; /**< The sum of the bounded slowdowns of the finished jobs */
+        double wait; /**< The sum of the wait times of the finished jobs */
+        double terminatedJobs; /**< The number of finished jobs */
+        double startedJobs; /**< The number of started jobs */
+
+        SimulationTotals() : usage(0), usageMem(0), fullUsage(0), fullUsageMem(0), slowdown(0), wait(0), terminatedJobs(0), startedJobs(0) {
         }
     };
 
-
-    /** Event queue that stores the pending events */
-    typedef set<SimulationEvent*, eventorder_t> EventQueue;
+    /**
+     * @author Francesc Guim,C6-E201,93 401 16 50,
+     */
 
     /**  The class that implements the event driven simulation. */
     class Simulation {
@@ -119,7 +95,7 @@ namespace Simulator {
 
     public:
         Simulation();
-        ~Simulation();
+        virtual ~Simulation();
         Simulation(SimulatorCharacteristics* SimInfo, Log* log, SystemOrchestrator *sysorch);
 
         virtual bool initSimulation();
@@ -132,7 +108,7 @@ namespace Simulator {
         uint64_t* getGlobalTimeRef();
 
         //The following functions are intended to be used for  external components, like scheduling policies, for  delete events or force creating new events. For example these functions are used by the deepSearchScheduling polcy.
-        void deleteJobEvents(Job* job); //be aware this function is quite costly if not invoqued with the second parameter that indicates that start time of when the simulation instance must start to look
+        void deleteJobEvents(Job* job); //uses the event handles of the job, it does not search the event queue
         void forceJobStart(double startTime, double endTime, Job* job);
         void deleteJobFinishEvent(Job* job);
         void forceJobFinish(double endTime, Job* job);
@@ -151,11 +127,19 @@ namespace Simulator {
         void setSlowdownBound(double bound);
         double getSlowdownBound() const;
 
+        void setEventQueueType(event_queue_type_t type);
+        void setBackfillInterval(double theValue);
+        double getBackfillInterval() const;
+
         //for debuggin stuff 
         void dumpEvents();
         void setStopSimulation(bool theValue);
         bool getStopSimulation() const;
 
+        //requests from the signal handlers, they reach every simulation of the process
+        static void requestStop();
+        static void requestStatistics();
+
         //progress stuff
         void setShowSimulationProgress(bool theValue);
         bool getshowSimulationProgress() const;
@@ -176,10 +160,27 @@ namespace Simulator {
         void simInsertComputeBeginEvent(Job *job);
         void simInsertComputeEndEvent(Job *job);
 
+        //deferred event operations, for the policies that run in other threads
+        void deferEvents(vector<DeferredEvent>* buffer);
+        void applyDeferredEvents(const vector<DeferredEvent>& buffer);
+
         SimulatorCharacteristics* getSimInfo();
 
+        //results, for the runs that do not report them themselves
+        void setReportResults(bool theValue);
+        bool getReportResults() const;
+        const SimulationTotals& getTotals() const;
+        int getNumberOfFinishedJobs() const;
 
-        int backfillcounter;
+        //partition event streams, every partition runs its own logical process
+        void setPartitionEventStreams(bool theValue);
+        bool getPartitionEventStreams() const;
+        void setPartitionLookahead(double theValue);
+        double getPartitionLookahead() const;
+        size_t advancePartition(double until);
+
+
+        std::atomic<int> backfillcounter; /**< The jobs started by the backfill, the partitions may count them at once */
     protected:
         //functions oriented to check all the events are released
         //int increaseJobEvents(Job* job); 
@@ -189,7 +190,13 @@ namespace Simulator {
 
         SystemOrchestrator* sysOrch; /**< A reference to the schedulingpolicy that is simulated*/
         SimulatorCharacteristics* SimInfo; /**< The characarcteristics of the current simulation  */
-        EventQueue events; /**< The queue of events that have to be treated */
+        EventQueue* events; /**< The queue of events that have to be treated */
+        EventPool eventPool; /**< Provides and recycles all the events of the simulation */
+        shared_ptr< vector<Job*> > submitOrder; /**< The jobs sorted by submit time when the job list is not in that order, NULL when the job list is read in place. The partitions share it */
+        map<int, Job*>::iterator nextListJob; /**< The next job of the job list to read */
+        size_t nextOrderedJob; /**< The next job of submitOrder to read */
+        Job* nextArrival; /**< The next job to arrive, already read so the time of the next batch is known, NULL when the whole workload has arrived */
+        int nextArrivalId; /**< The last id given to an arrival or schedule event of the workload, they take the ids below the ones of the rest of events */
         uint64_t globalTime; /**< The current time of the simulation  */
         Log* log; /** The logging engine */
         int lastEventId; /**< The last id assigned to an event , the ids for events must be unique */
@@ -205,10 +212,13 @@ namespace Simulator {
 
         // statistical collector 
         double collectStatisticsInterval; /**< indicates when the simulator will have to collect the punctual statistics that are not associated whit any event (by default it is 10 minutes), */
+        double backfillInterval; /**< The period of the backfill cycles, 0 means that there are no backfill events */
         PolicyEntityCollector* policyCollector;
 
         //this function collects all the statistics that are associated to the current execution 
         void collectFinalStatistics();
+        void showResults();
+        bool reportResults; /**< Indicates if the summary and the statistics files are generated when the simulation finishes */
         CSVJobsInfoConverter* JobsSimulationPerformance; /**< This CVS converter, in case of created, will store all the information concerning the jobs once the simulation is finished  */
         CSVPolicyInfoConverter* PolicySimulationPerformance; /**< This CSV converer, in case of created, will store the information coserning the policy once the simulation is finished */
 
@@ -219,12 +229,39 @@ namespace Simulator {
         bool firstShow; /**< Indicates if it is the first time that the progress is shown, this is for delete the appropiate number of chars in the desplay */
         double totalItems; /**< total bullets to shown in the progress bar */
         void showProgress(double current, double total); //shows to the STDIO the progress respect the total and the current processed stuff
+
+        //event queue handling, keeps the per job event handles up to date
+        void queueEvent(SimulationEvent* event);
+        void unqueueEvent(SimulationEvent* event);
+        SimulationEvent* findJobFinishEvent(Job* job);
+        void insertEvent(event_t type, Job* job, double time);
+        void modifyJobFinishEvent(Job* job, double time);
+        void initArrivals();
+        bool admitArrival(Job* job);
+        Job* readNextArrival();
+        void injectArrivals();
+        size_t getNumberOfPendingEvents() const;
+        double getNextEventTime() const;
         string getStringEvent(event_t type);
+        void treatEvent(SimulationEvent* event);
+
+        //partition event streams
+        void initPartitionSimulations();
+        void runPartitionSimulations();
+        size_t getPartitionPendingEvents() const;
+        Partition* partition; /**< The partition whose events are treated by this logical process, NULL for the whole system */
+        vector<Simulation*> partitionSimulations; /**< The logical processes of the partitions, empty if there is a single event stream */
+        bool partitionEventStreams; /**< Indicates if every partition has to run its own event stream */
+        double partitionLookahead; /**< The simulated time that the logical processes advance between two barriers, 0 for no limit */
+        event_queue_type_t eventQueueType; /**< The implementation of the event queue */
 
         //last event and job treated for dumping current status 
         event_t lastEventType; /**< The last event treated  */
         Job* lastProcessedJob; /**< The last processed job  */
         double startTimeFirstJob;
+        bool firstJobStarted; /**< Indicates if a job has already started */
+        int consecutiveStatisticsCollection; /**< The statistics events treated one after the other, they are not collected after 5 */
+        SimulationTotals totals; /**< The totals of the treated events */
         int usefull; /* save how many processors per runtime will be used in simulation */
 
         int numberOfFinishedJobs;
@@ -233,6 +270,11 @@ namespace Simulator {
         SimulationEvent* finishjob;
 
         trace* output_trace; // Generic class for all output traces.
+
+        sig_atomic_t statisticsRequestsSeen; /**< The statistics requests already shown by this simulation */
+        static volatile sig_atomic_t stopRequests; /**< The stop requests received by the process */
+        static volatile sig_atomic_t statisticsRequests; /**< The statistics requests received by the process */
+        static thread_local vector<DeferredEvent>* deferredEvents; /**< Where the event operations of the current thread go, NULL if they are applied at once */
     };
 
 }
@@ -35,13 +35,7 @@ SimulationEvent::SimulationEvent(event_t type,Job* job,int id,double time)
   this->job = job;
   this->id = id;
   this->time = time;
-}
-
-/**
- * The default destructor for the class 
- */
-SimulationEvent::~SimulationEvent()
-{
+  this->queuePosition = -1;
 }
 
 /**
@@ -113,4 +107,22 @@ void SimulationEvent::setJob(Job* theValue)
   job = theValue;
 }
 
+/**
+ * Sets the position of the event in the event queue heap
+ * @param theValue The heap slot, -1 if the event is not queued
+ */
+void SimulationEvent::setQueuePosition(int theValue)
+{
+  queuePosition = theValue;
+}
+
+/**
+ * Returns the position of the event in the event queue heap
+ * @return The heap slot, -1 if the event is not queued
+ */
+int SimulationEvent::getQueuePosition() const
+{
+  return queuePosition;
+}
+
 }
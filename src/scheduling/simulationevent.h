@@ -49,13 +49,12 @@ namespace Simulator {
 */
 
 /**
-* This class implements a simulation event.
+* This class implements a simulation event. It is kept trivially copyable so the events can be recycled by the EventPool.
 * @see The class simulation
 */
 class SimulationEvent{
 public:
   SimulationEvent(event_t type,Job* job,int id,double time);
-  ~SimulationEvent();
   void setId(const int& theValue);
   int getid() const;
   void setTime(const double& theValue);
@@ -64,6 +63,8 @@ public:
   event_t getType() const;
   void setJob(Job* theValue);
   Job* getJob() const;
+  void setQueuePosition(int theValue);
+  int getQueuePosition() const;
 
 
 private:
@@ -72,8 +73,7 @@ private:
   double time; /**< the time associated to event .. when it must be triggered..*/
   int id; /** the id for the event */
   event_t type; /**< which kind of event .*/
-
-  vector<Job*> job_vector; /** vector of jobs in this event */
+  int queuePosition; /**< the slot that the event occupies in the event queue heap, -1 if it is not queued */
 
 };
 
@@ -0,0 +1,241 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/slurmpriority.h>
+#include <utils/simulationconfiguration.h>
+#include <utils/log.h>
+
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+
+using namespace std;
+
+namespace Simulator {
+
+    /**
+     * The constructor for the class
+     * @param config The simulation configuration, that contains the weights and the parameters of the factors
+     * @param totalCPUs The cpus of the system
+     * @param startTime The time when the simulation starts, the usage is decayed from it
+     * @param log A reference to the logging engine
+     */
+    SLURMPriority::SLURMPriority(Utils::SimulationConfiguration* config, uint64_t totalCPUs, double startTime, Utils::Log* log) : total(startTime) {
+        this->weightAge = config->SLURMWeightAge;
+        this->weightFairShare = config->SLURMWeightFairShare;
+        this->weightJobSize = config->SLURMWeightJobSize;
+        this->weightPartition = config->SLURMWeightPartition;
+        this->weightQOS = config->SLURMWeightQOS;
+        this->maxAge = config->SLURMMaxAge;
+        this->decayHalfLife = config->SLURMDecayHalfLife;
+        this->calcPeriod = config->SLURMCalcPeriod;
+        this->favorSmall = config->SLURMFavorSmall;
+        this->partitionPriorities = config->SLURMPartitionPriorities;
+        this->qosPriorities = config->SLURMQOSPriorities;
+        this->totalCPUs = totalCPUs;
+        this->lastCalcTime = startTime;
+        this->log = log;
+    }
+
+    /**
+     * The destructor for the class
+     */
+    SLURMPriority::~SLURMPriority() {
+    }
+
+    /**
+     * Returns if the multifactor priority is used, that is if any of the weights is not 0
+     * @return True if the multifactor priority is used
+     */
+    bool SLURMPriority::isEnabled() {
+        return this->weightAge > 0 or this->weightFairShare > 0 or this->weightJobSize > 0 or this->weightPartition > 0 or this->weightQOS > 0;
+    }
+
+    /**
+     * Returns the seconds that a job has to wait to get one more point of priority from the age factor
+     * @return The seconds per point of age priority, 0 if the age has no weight
+     */
+    double SLURMPriority::getAgeInterval() {
+        if (this->weightAge <= 0 or this->maxAge <= 0)
+            return 0;
+        return this->maxAge / this->weightAge;
+    }
+
+    /**
+     * Returns the weighted sum of the factors of a job that do not depend on its age, with the fair-share of its user
+     * as it was computed the last time
+     * @param job The job
+     * @return The priority of the job without the age factor
+     */
+    double SLURMPriority::getFactors(Job* job) {
+        double priority = this->weightFairShare * this->getFairShare(job->getUserID());
+        priority += this->weightJobSize * this->getJobSize(job);
+        priority += this->weightPartition * this->getListFactor(this->partitionPriorities, job->getPartitionNumber());
+        priority += this->weightQOS * this->getListFactor(this->qosPriorities, job->getQueueNumber());
+        return priority;
+    }
+
+    /**
+     * Returns the fair-share factor of a user as it was computed the last time
+     * @param user The user
+     * @return The fair-share factor, 1 for the users that have not used the system
+     */
+    double SLURMPriority::getFairShare(int user) {
+        map<int, SLURMUsage>::iterator it = this->users.find(user);
+        if (it == this->users.end())
+            return 1;
+        return it->second.fairShare;
+    }
+
+    /**
+     * Charges the user of a job with the cpus of the job from now on
+     * @param job The job that starts
+     * @param time The current time
+     */
+    void SLURMPriority::jobStart(Job* job, double time) {
+        map<int, SLURMUsage>::iterator it = this->users.insert(make_pair(job->getUserID(), SLURMUsage(time))).first;
+        this->getUsage(it->second, time);
+        this->getUsage(this->total, time);
+        it->second.cpus += job->getNumberProcessors();
+        this->total.cpus += job->getNumberProcessors();
+        it->second.fairShare = this->getFairShare(it->second, time);
+    }
+
+    /**
+     * Stops charging the user of a job with the cpus of the job, the usage until now is kept
+     * @param job The job that finishes
+     * @param time The current time
+     */
+    void SLURMPriority::jobFinish(Job* job, double time) {
+        map<int, SLURMUsage>::iterator it = this->users.find(job->getUserID());
+        assert(it != this->users.end());
+        this->getUsage(it->second, time);
+        this->getUsage(this->total, time);
+        it->second.cpus -= job->getNumberProcessors();
+        this->total.cpus -= job->getNumberProcessors();
+        assert(it->second.cpus >= 0 and this->total.cpus >= 0);
+        it->second.fairShare = this->getFairShare(it->second, time);
+    }
+
+    /**
+     * Returns if the calculation period has passed since the last time that all the fair-share factors were
+     * recalculated, in that case the caller has to update them with updateFairShare
+     * @param time The current time
+     * @return True if the fair-share factors have to be recalculated
+     */
+    bool SLURMPriority::refresh(double time) {
+        if (this->calcPeriod <= 0 or this->weightFairShare <= 0 or time - this->lastCalcTime < this->calcPeriod)
+            return false;
+        this->lastCalcTime = time;
+        return true;
+    }
+
+    /**
+     * Recalculates the fair-share factor of a user
+     * @param user The user
+     * @param time The current time
+     * @return True if the factor has changed
+     */
+    bool SLURMPriority::updateFairShare(int user, double time) {
+        map<int, SLURMUsage>::iterator it = this->users.find(user);
+        if (it == this->users.end())
+            return false;
+        double fairShare = this->getFairShare(it->second, time);
+        if (fairShare == it->second.fairShare)
+            return false;
+        it->second.fairShare = fairShare;
+        return true;
+    }
+
+    /**
+     * Returns the users that have used the system
+     * @return The users
+     */
+    vector<int> SLURMPriority::getUsers() {
+        vector<int> users;
+        for (map<int, SLURMUsage>::iterator it = this->users.begin(); it != this->users.end(); ++it)
+            users.push_back(it->first);
+        return users;
+    }
+
+    /**
+     * Brings a usage to the given time: the usage until its time is decayed and the cpus that are running since then
+     * are added, decayed along the way
+     * @param usage The usage
+     * @param time The current time
+     * @return The usage at time
+     */
+    double SLURMPriority::getUsage(SLURMUsage& usage, double time) {
+        double elapsed = time - usage.time;
+        assert(elapsed >= 0);
+        if (this->decayHalfLife <= 0) {
+            usage.usage += usage.cpus * elapsed;
+        } else {
+            double decay = pow(2.0, -elapsed / this->decayHalfLife);
+            usage.usage = usage.usage * decay + usage.cpus * this->decayHalfLife / M_LN2 * (1 - decay);
+        }
+        usage.time = time;
+        return usage.usage;
+    }
+
+    /**
+     * Computes the fair-share factor of a user as the classic SLURM one, 2^(-effective usage / normalized shares),
+     * where every user that has used the system has the same shares
+     * @param usage The usage of the user
+     * @param time The current time
+     * @return The fair-share factor
+     */
+    double SLURMPriority::getFairShare(SLURMUsage& usage, double time) {
+        double total = this->getUsage(this->total, time);
+        if (total <= 0)
+            return 1;
+        double effectiveUsage = this->getUsage(usage, time) / total;
+        double shares = 1.0 / this->users.size();
+        return pow(2.0, -effectiveUsage / shares);
+    }
+
+    /**
+     * Returns the job size factor of a job, relative to the cpus of the system
+     * @param job The job
+     * @return The job size factor
+     */
+    double SLURMPriority::getJobSize(Job* job) {
+        if (this->totalCPUs == 0)
+            return 0;
+        double size = min(1.0, (double) job->getNumberProcessors() / this->totalCPUs);
+        return this->favorSmall ? 1 - size : size;
+    }
+
+    /**
+     * Returns the factor of an entry of a list of priorities, its priority relative to the maximum one
+     * @param priorities The priorities
+     * @param index The entry
+     * @return The factor, 0 for the entries that are not in the list
+     */
+    double SLURMPriority::getListFactor(const vector<double>& priorities, int index) {
+        if (index < 0 or index >= (int) priorities.size())
+            return 0;
+        double maximum = *max_element(priorities.begin(), priorities.end());
+        if (maximum <= 0)
+            return 0;
+        return priorities[index] / maximum;
+    }
+
+}
@@ -0,0 +1,103 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATORSLURMPRIORITY_H
+#define SIMULATORSLURMPRIORITY_H
+
+#include <scheduling/job.h>
+
+#include <map>
+#include <vector>
+
+using std::map;
+using std::vector;
+
+namespace Utils {
+    class Log;
+    class SimulationConfiguration;
+}
+
+namespace Simulator {
+
+    /**
+     * The usage of a user, or of all of them together, decayed with the half life. The decay is applied lazily: the
+     * usage is only brought to the current time when the user starts or finishes a job or when it is asked for.
+     */
+    struct SLURMUsage {
+        double usage; /**< The decayed cpu seconds used until time */
+        double cpus; /**< The cpus that the running jobs are using since time */
+        double time; /**< The time when the usage was computed */
+        double fairShare; /**< The fair-share factor computed the last time that the user was charged or refreshed */
+
+        SLURMUsage(double time = 0) : usage(0), cpus(0), time(time), fairShare(1) {
+        }
+    };
+
+    /**
+     * Implements the multifactor priority of SLURM: the priority of a job is the weighted sum of its age, fair-share,
+     * job size, partition and QOS factors, all of them between 0 and 1. The age is not included in the factors computed
+     * here, it is left to the SLURM job queue, which makes it grow with the time without touching the jobs.
+     * The usage of every user is kept decayed with the half life and it is updated when its jobs start and finish, in
+     * constant time, so only the pending jobs of the user have to be reordered.
+     */
+    class SLURMPriority {
+    public:
+        SLURMPriority(Utils::SimulationConfiguration* config, uint64_t totalCPUs, double startTime, Utils::Log* log);
+        ~SLURMPriority();
+
+        bool isEnabled();
+        double getAgeInterval();
+        double getFactors(Job* job);
+        double getFairShare(int user);
+
+        void jobStart(Job* job, double time);
+        void jobFinish(Job* job, double time);
+        bool refresh(double time);
+        bool updateFairShare(int user, double time);
+        vector<int> getUsers();
+
+    private:
+        double getUsage(SLURMUsage& usage, double time);
+        double getFairShare(SLURMUsage& usage, double time);
+        double getJobSize(Job* job);
+        double getListFactor(const vector<double>& priorities, int index);
+
+        double weightAge; /**< The weight of the age factor */
+        double weightFairShare; /**< The weight of the fair-share factor */
+        double weightJobSize; /**< The weight of the job size factor */
+        double weightPartition; /**< The weight of the partition factor */
+        double weightQOS; /**< The weight of the QOS factor */
+        double maxAge; /**< The age at which the age factor of a job is 1 */
+        double decayHalfLife; /**< The time in which the usage of a user loses half of its value, 0 for no decay */
+        double calcPeriod; /**< The period in which all the fair-share factors are recalculated, 0 for never */
+        bool favorSmall; /**< If the job size factor favours the small jobs instead of the big ones */
+        vector<double> partitionPriorities; /**< The priority of every partition, by partition number */
+        vector<double> qosPriorities; /**< The priority of every QOS, by queue number */
+        uint64_t totalCPUs; /**< The cpus of the system, the job size factor is relative to them */
+
+        map<int, SLURMUsage> users; /**< The usage of every user that has submitted a job */
+        SLURMUsage total; /**< The usage of all the users together */
+        double lastCalcTime; /**< The last time that all the fair-share factors were recalculated */
+        Utils::Log* log; /**< A reference to the logging engine */
+    };
+
+}
+
+#endif
@@ -61,8 +61,17 @@ namespace Simulator {
         this->runningQueue.setLog(log);
         //        this->startNowQueue.setLog(log);
         this->scheduledQueue.setLog(log);
+        // The priority ages with the time instead of being increased on each pass
+        Utils::SimulationConfiguration* simuConfig = this->architecture->getSystemOrchestrator()->getsimuConfig();
+        this->priority = new SLURMPriority(simuConfig, this->architecture->getNumberCPUs(), globalTime, log);
+        double ageInterval = this->priority->isEnabled() ? this->priority->getAgeInterval() : simuConfig->SLURMAgeInterval;
+        this->waitingQueue.setAgeInterval(ageInterval);
+        this->scheduledQueue.setAgeInterval(ageInterval);
+        this->runningQueue.setAgeInterval(ageInterval);
+        this->finishedQueue.setAgeInterval(ageInterval);
         this->lastscheduletime = globalTime;
         this->bf_counter = 0;
+        this->backfillPool = new Utils::ThreadPool((simuConfig->SLURMBackfillThreads > 1) ? simuConfig->SLURMBackfillThreads : 1);
         if (this->architecture->getSystemOrchestrator()->getsimuConfig()->SLURMPmem != 0) {
             this->persist = AVAILABLE;
         } else {
@@ -78,13 +87,15 @@ namespace Simulator {
     SLURMSchedulingPolicy::~SLURMSchedulingPolicy() {
         /* free the  reservationTable */
         delete this->reservationTable;
+        delete this->priority;
+        delete this->backfillPool;
     }
 
     void SLURMSchedulingPolicy::backfill() {
 
-        log->debug("BACKFILL Started", 1);
+        LOG_DEBUG(log, "BACKFILL Started", 1);
         if (this->skip_backfill) {
-            log->debug("BACKFILL Skipped", 1);
+            LOG_DEBUG(log, "BACKFILL Skipped", 1);
             return;
         }
         this->skip_backfill = true;
@@ -97,11 +108,16 @@ namespace Simulator {
          */
 
         // Get the size of the wait queue to parse on each run of schedule() from the simulation configuration.
-        int WQlimit = this->architecture->getSystemOrchestrator()->getsimuConfig()->SLURMWQsize;
+        Utils::SimulationConfiguration* simuConfig = this->architecture->getSystemOrchestrator()->getsimuConfig();
+        int WQlimit = simuConfig->SLURMWQsize;
 
         // Track how many reservations we allocate (in this pass).
         int numberOfReservationsCur = 0; // Counts the number of jobs assigned with the backfill algorithm.
 
+        // Like bf_max_job_test and bf_max_job_user in SLURM, the jobs tested in a cycle are limited, in total and per user.
+        int testedJobs = 0;
+        map<int, int> testedUserJobs;
+
         // Try to skip past jobs already dealt with in the PRIORITY Q.
         Job* job = this->waitingQueue.begin();
 
@@ -109,6 +125,9 @@ namespace Simulator {
             job = waitingQueue.next();
         }
 
+        // The whole pass is a transaction, the jobs that get the same reservations again do not change the timelines
+        ((ResourceReservationTable*)this->reservationTable)->beginTransaction();
+
         for (Job* wlim = job; wlim != NULL; wlim = this->waitingQueue.next()) {
             this->reservationTable->deallocateJob(wlim);
         }
@@ -121,40 +140,90 @@ namespace Simulator {
             job = waitingQueue.next();
         }
 
+        // The jobs tested in this cycle, in priority order.
+        vector<Job*> candidates;
         for (; job != NULL; job = this->waitingQueue.next()) {
-            log->debug("BACKFILL Scheduling for job " + to_string(job->getJobNumber()) + " and is preceeded by " + to_string(job->getPrecedingJobNumber()), 1);
-            log->debug("BACKFILL Scheduling and currently have " + to_string(numberOfReservationsCur) + " reservations.", 2);
-            ResourceJobAllocation* allocation = ((ResourceReservationTable*)this->reservationTable)->findPossibleAllocation(job, globalTime, job->getRequestedTime());
-            if (!allocation->getAllocationProblem()) {
-                // The allocations that can run now.
-                ResourceJobAllocation *best = findBestAllocation(job, allocation);
-                assert(best->getAllocations().size() > 0);
-                this->scheduleJob(job, best);
-                this->sim->backfillcounter++;
+            if (simuConfig->SLURMBackfillMaxJobTest > 0 && testedJobs == simuConfig->SLURMBackfillMaxJobTest) {
+                LOG_DEBUG(log, "BACKFILL Hit the max number of jobs tested.", 2);
+                break;
+            }
+            if (simuConfig->SLURMBackfillMaxJobUser > 0 && testedUserJobs[job->getUserID()] == simuConfig->SLURMBackfillMaxJobUser)
+                continue;
+            testedJobs++;
+            testedUserJobs[job->getUserID()]++;
+            candidates.push_back(job);
+        }
 
-            } else {
-                if ((this->numberOfReservations != -1) && (numberOfReservationsCur == this->numberOfReservations)) {
-                    log->debug("BACKFILL Hit the max number of reservations.", 2);
+        /*
+         * Whether the jobs can start now is checked for a window of candidates at once, against the table as it is before any of them
+         * is scheduled, and the results are then used in priority order as if they had been checked one after the other:
+         * a job that cannot start does not fit either once other jobs have taken resources, and a job that can start gets the same
+         * allocation unless a job scheduled before it in the window took one of its candidate nodes, then it is checked again.
+         * The later reservations are always searched one after the other. The debug output is not thread safe, so the window
+         * has a single job when the table writes it.
+         */
+        ResourceReservationTable* table = (ResourceReservationTable*) this->reservationTable;
+        uint32_t threads = this->log->isDebugEnabled(2) ? 1 : this->backfillPool->getNumberOfThreads();
+        size_t windowSize = (threads > 1) ? threads * SLURM_BACKFILL_JOBS_PER_THREAD : 1;
+
+        for (size_t first = 0; first < candidates.size(); first += windowSize) {
+            size_t last = (first + windowSize < candidates.size()) ? first + windowSize : candidates.size();
+
+            vector<SLURMAllocationSearch> searches;
+            vector<Utils::ThreadPoolTask*> tasks;
+            searches.reserve(last - first);
+            for (size_t i = first; i < last; i++) {
+                LOG_DEBUG(log, "BACKFILL Scheduling for job " + to_string(candidates[i]->getJobNumber()) + " and is preceeded by " + to_string(candidates[i]->getPrecedingJobNumber()), 1);
+                LOG_DEBUG(log, "BACKFILL Scheduling and currently have " + to_string(numberOfReservationsCur) + " reservations.", 2);
+                searches.push_back(SLURMAllocationSearch(table, candidates[i], globalTime));
+                tasks.push_back(&searches.back());
+            }
+            this->backfillPool->run(tasks);
+
+            map<uint32_t, double> takenNodes; // The earliest start of the jobs scheduled in this window on every node.
+            for (size_t i = 0; i < searches.size(); i++) {
+                Job* job = searches[i].job;
+                ResourceJobAllocation* allocation = searches[i].allocation;
+                if (!allocation->getAllocationProblem() && this->usesTakenNodes(allocation, takenNodes)) {
                     delete allocation;
-                    continue;
+                    allocation = table->findPossibleAllocation(job, globalTime, job->getRequestedTime());
                 }
-                //                 find a later allocation and reserve it
-                log->debug("Failed to find possible, trying findAllocation.", 2);
-                delete allocation;
-                ResourceJobAllocation* allocation = findFutureAllocation(job, globalTime, job->getRequestedTime());
-                assert(allocation->getStartTime() != globalTime);
-                this->log->debug("The job " + to_string(job->getJobNumber()) + " will start later.", 2);
+
+                ResourceJobAllocation* best = NULL;
                 if (!allocation->getAllocationProblem()) {
-                    ResourceJobAllocation* best = findBestAllocation(job, allocation);
+                    // The allocations that can run now.
+                    best = findBestAllocation(job, allocation);
                     assert(best->getAllocations().size() > 0);
                     this->scheduleJob(job, best);
-                    this->log->debug("The job " + to_string(job->getJobNumber()) + " can start @ " + ftos(allocation->getStartTime()), 2);
-                    numberOfReservationsCur++;
-                    log->debug("BACKFILL scheduled job " + to_string(job->getJobNumber()) + "and resCur is " + to_string(numberOfReservationsCur), 2);
+                    this->sim->backfillcounter++;
+
                 } else {
+                    if ((this->numberOfReservations != -1) && (numberOfReservationsCur == this->numberOfReservations)) {
+                        LOG_DEBUG(log, "BACKFILL Hit the max number of reservations.", 2);
+                        delete allocation;
+                        continue;
+                    }
+                    //                 find a later allocation and reserve it
+                    LOG_DEBUG(log, "Failed to find possible, trying findAllocation.", 2);
                     delete allocation;
-                }
+                    allocation = findFutureAllocation(job, globalTime, job->getRequestedTime(), simuConfig->SLURMBackfillResolution);
+                    assert(allocation->getStartTime() != globalTime);
+                    LOG_DEBUG(this->log, "The job " + to_string(job->getJobNumber()) + " will start later.", 2);
+                    if (!allocation->getAllocationProblem()) {
+                        double startTime = allocation->getStartTime();
+                        best = findBestAllocation(job, allocation);
+                        assert(best->getAllocations().size() > 0);
+                        this->scheduleJob(job, best);
+                        LOG_DEBUG(this->log, "The job " + to_string(job->getJobNumber()) + " can start @ " + ftos(startTime), 2);
+                        numberOfReservationsCur++;
+                        LOG_DEBUG(log, "BACKFILL scheduled job " + to_string(job->getJobNumber()) + "and resCur is " + to_string(numberOfReservationsCur), 2);
+                    } else {
+                        delete allocation;
+                    }
 
+                }
+                if (best != NULL && windowSize > 1)
+                    this->takeNodes(best, takenNodes);
             }
         }
 
@@ -162,9 +231,11 @@ namespace Simulator {
         for (Job *job = this->scheduledQueue.begin(); job != NULL; job = this->scheduledQueue.next()) {
             this->waitingQueue.erase(job);
         }
+
+        ((ResourceReservationTable*)this->reservationTable)->commitTransaction();
         
         this->lastscheduletime = globalTime;
-        log->debug("BACKFILL Finished", 1);
+        LOG_DEBUG(log, "BACKFILL Finished", 1);
 
 
     }
@@ -176,17 +247,25 @@ namespace Simulator {
      * In standard nomenclature, this is scheduling, RRT is placement.
      */
     void SLURMSchedulingPolicy::schedule() {
-        log->debug("Running SLURM Schedule.", 2);
-        log->debug("Current number of reservations: " + to_string(numberOfReservations), 4);
-        log->debug("Last Schedule Time: " + std::to_string(this->lastscheduletime), 4);
-        log->debug("SLURM Skip Time: " + std::to_string(this->architecture->getSystemOrchestrator()->getsimuConfig()->SLURMSkipTime), 4);
+        LOG_DEBUG(log, "Running SLURM Schedule.", 2);
+        LOG_DEBUG(log, "Current number of reservations: " + to_string(numberOfReservations), 4);
+        LOG_DEBUG(log, "Last Schedule Time: " + std::to_string(this->lastscheduletime), 4);
+        LOG_DEBUG(log, "SLURM Skip Time: " + std::to_string(this->architecture->getSystemOrchestrator()->getsimuConfig()->SLURMSkipTime), 4);
 
 
         // If there was a scheduling event within "SLURMSKipTime" seconds, don't run. This mimics SLURM and stops over-scheduling which eats time in real systems.
         if ((this->lastscheduletime > 0) && ((this->globalTime - this->lastscheduletime) < this->architecture->getSystemOrchestrator()->getsimuConfig()->SLURMSkipTime)) {
-            log->debug("Skipping Schedule due to short time period since last run.", 2);
+            LOG_DEBUG(log, "Skipping Schedule due to short time period since last run.", 2);
             return;
         }
+        // Recalculate the fair-share factors of all the users once per calculation period, like SLURM does
+        if (this->priority->isEnabled() and this->priority->refresh(globalTime)) {
+            vector<int> users = this->priority->getUsers();
+            for (vector<int>::iterator it = users.begin(); it != users.end(); ++it)
+                if (this->priority->updateFairShare(*it, globalTime))
+                    this->reprioritizeJobs(*it);
+        }
+
         /*
          * Reminder of which queues we have in play...
          *        SLURMJobQueue waitQueue;      The wait queue job list
@@ -195,10 +274,13 @@ namespace Simulator {
          *        SLURMJobQueue reservedQueue;  Jobs that are reserved to start now
          */
 
+        // The whole pass is a transaction, the jobs that get the same reservations again do not change the timelines
+        ((ResourceReservationTable*)this->reservationTable)->beginTransaction();
+
         // First clear all previous reservations that have been allocated.
         // This should be a no-op as jobs in the waitingQueue should never have allocations.
         for (Job* waitjob = this->waitingQueue.begin(); waitjob != NULL; waitjob = this->waitingQueue.next()) {
-            log->debug("Deallocating Job " + to_string(waitjob->getJobNumber()), 2);
+            LOG_DEBUG(log, "Deallocating Job " + to_string(waitjob->getJobNumber()), 2);
             this->reservationTable->deallocateJob(waitjob);
         }
 
@@ -207,17 +289,17 @@ namespace Simulator {
         int WQlimit = this->architecture->getSystemOrchestrator()->getsimuConfig()->SLURMWQsize;
 
         if (log->getLevel() >= 8) {
-            waitingQueue.dump();
-            scheduledQueue.dump();
+            waitingQueue.dump(globalTime);
+            scheduledQueue.dump(globalTime);
         }
 
         // Really, I want to delete the allocation but hold onto it, call findFutureAllocation, see if the start time is earlier.
         // If so, go with the new and forget the old. If not, stick with the old.
-        log->debug("Moving all jobs from scheduleQ to waitingQ for re-scheduling.", 2);
+        LOG_DEBUG(log, "Moving all jobs from scheduleQ to waitingQ for re-scheduling.", 2);
 
         // If we do this, really, there is no need for a separate scheduledQ and waitingQ
         // It merely serves to remind that it's possible to do it for, say, some guaranteed scheduling
-        for (Job* job = this->scheduledQueue.begin(); job != NULL; job = this->scheduledQueue.next()) {
+        for (Job* job = this->scheduledQueue.headJob(); job != NULL; job = this->scheduledQueue.headJob()) {
             this->sim->deleteJobEvents(job);
             this->reservationTable->deallocateJob(job);
             this->scheduledQueue.erase(job);
@@ -226,42 +308,11 @@ namespace Simulator {
 
         int i = 0;
         for (Job* job = this->waitingQueue.begin(); job != NULL && i < WQlimit; job = this->waitingQueue.next(), ++i) {
-            log->debug("PRIORITY Scheduling for job " + to_string(job->getJobNumber()) + " which is preceeded by " + vtos(job->getPreceedingJobs()), 1);
-
-
-            /*
-             * This keeps jobs in a workflow from being scheduled until the preceeding job is finished.
-             */
-            vector<int> _prej = job->getPreceedingJobs();
-            int _prej_count = _prej.size();
-            if (_prej.empty() == false) {
-
-                // Look through the finished queue, this is very slow, but currently necessary
-                for (Job* finjob = this->finishedQueue.begin(); finjob != NULL; finjob = this->finishedQueue.next()) {
-
-                    if ((std::find(_prej.begin(), _prej.end(), finjob->getJobNumber()) != _prej.end()) == true) {
-                        if (finjob->getJobSimStatus() == COMPLETED) {
-                            log->debug("Job " + to_string(job->getJobNumber()) + " has preceeding jobs [" + vtos(job->getPreceedingJobs()) + "]. Job " + itos(finjob->getJobNumber()) + " is COMPLETED.", 2);
-                            _prej_count--; // Found a completed, preceeding job, decr counter
-                        } else {
-                            log->debug("Job " + to_string(job->getJobNumber()) + " has preceeding jobs [" + vtos(job->getPreceedingJobs()) + "]. Job " + itos(finjob->getJobNumber()) + " is NOT COMPLETED.", 2);
-                        }
-
-
-                    }
-                }
-
-                // If we have examined all jobs in the finished queue, and all preceeding jobs and determined that
-                // the current job has some unfinished preceeding jobs, skip to the next job in the WAITING QUEUE
-                if (_prej_count != 0) {
-                    log->debug("Job " + to_string(job->getJobNumber()) + " has preceeding jobs [" + vtos(job->getPreceedingJobs()) + "]. Some are NOT COMPLETED, moving to next job in WQ.", 2);
-                    continue;
-                }
+            LOG_DEBUG(log, "PRIORITY Scheduling for job " + to_string(job->getJobNumber()) + " which is preceeded by " + vtos(job->getPreceedingJobs()), 1);
 
 
-            } else {
-                log->debug("Job " + to_string(job->getJobNumber()) + " has no preceeding jobs.", 2);
-            }
+            // The jobs of a workflow only get to the waiting queue once all their preceeding jobs have finished
+            LOG_DEBUG(log, "Job " + to_string(job->getJobNumber()) + " has " + to_string(job->getPredecessors().size()) + " finished preceeding jobs.", 2);
 
             if (this->persist == AVAILABLE){
                 // Shorten jobs if the workflow status is '2' which means 'CONTINUE'
@@ -271,21 +322,21 @@ namespace Simulator {
                     _jobiorat = 1.0 - _jobiorat;
                     _jobrt = _jobiorat * _jobrt;
                     job->setIOCompRatio(0.0);
-                    log->debug("Job " + to_string(job->getJobNumber()) + " used to have runtime of " + to_string(job->getRequestedTime()) + " now shortened to " + to_string(_jobrt), 2);
+                    LOG_DEBUG(log, "Job " + to_string(job->getJobNumber()) + " used to have runtime of " + to_string(job->getRequestedTime()) + " now shortened to " + to_string(_jobrt), 2);
                     job->setRequestedTime(_jobrt);
                     job->setRunTime(_jobrt);
                 }
             }
 
             ResourceJobAllocation* possible_nodes = findFutureAllocation(job, globalTime, job->getRequestedTime());
-            log->debug("Tried to find FUTURE for " + to_string(job->getJobNumber()) + " and result was " + to_string(possible_nodes->getallocationReason()), 2);
+            LOG_DEBUG(log, "Tried to find FUTURE for " + to_string(job->getJobNumber()) + " and result was " + to_string(possible_nodes->getallocationReason()), 2);
             if (!possible_nodes->getAllocationProblem()) {
                 ResourceJobAllocation *best_nodes = findBestAllocation(job, possible_nodes); // This finds a future reservation and essentially just picks something from the array of possibles
                 assert(best_nodes->getAllocations().size() > 0); // Make sure the allocation for this job is >0 nodes.
-                log->debug("Job " + to_string(job->getJobNumber()) + " has best nodes of size " + to_string(best_nodes->getAllocations().size()), 2);
+                LOG_DEBUG(log, "Job " + to_string(job->getJobNumber()) + " has best nodes of size " + to_string(best_nodes->getAllocations().size()), 2);
                 this->scheduleJob(job, best_nodes); // Place the job in the RRT.
             } else {
-                log->debug("Cannot allocate FUTURE job " + to_string(job->getJobNumber()) + " due to " + to_string(possible_nodes->getallocationReason()), 2);
+                LOG_DEBUG(log, "Cannot allocate FUTURE job " + to_string(job->getJobNumber()) + " due to " + to_string(possible_nodes->getallocationReason()), 2);
                 delete possible_nodes;
             }
 
@@ -300,21 +351,16 @@ namespace Simulator {
         }
 
         // For jobs that have been dealt with by the PRIORITY queue and allocated, remove them from the waitQueue.
+        // The priority of the jobs that are still waiting is not touched, it grows with their age.
         for (Job *job = this->scheduledQueue.begin(); job != NULL; job = this->scheduledQueue.next()) {
-            log->debug("Updating priority for job: " + to_string(job->getJobNumber()) + " to be: " + to_string(job->getslurmprio() + 1), 2);
-            job->setslurmprio((uint32_t) (job->getslurmprio() + 1));
             this->waitingQueue.erase(job);
         }
 
 
-        for (Job* job = this->waitingQueue.begin(); job != NULL; job = this->waitingQueue.next()) {
-            log->debug("Updating priority for job: " + to_string(job->getJobNumber()) + " to be: " + to_string(job->getslurmprio() + 1), 2);
-            job->setslurmprio((uint32_t) (job->getslurmprio() + 1));
-        }
-
+        ((ResourceReservationTable*)this->reservationTable)->commitTransaction();
 
         this->lastscheduletime = globalTime;
-        log->debug("Scheduling Finished", 1);
+        LOG_DEBUG(log, "Scheduling Finished", 1);
 
         // Backfilling needs to happen somewhere here.
         if ((this->bf_counter > 0) && (this->bf_counter % 10 == 0)) {
@@ -335,6 +381,27 @@ namespace Simulator {
     void SLURMSchedulingPolicy::jobArrive(Job * job) {
         //first we call to the upper class that will make some arrangements in the jobs, like updated the job run time  according the jobruntime factor
         SchedulingPolicy::jobArrive(job);
+        if (this->priority->isEnabled())
+            this->pendingJobs[job->getUserID()].insert(job);
+
+        // A job of a workflow waits out of the queues until its preceeding jobs finish
+        if (job->getUnmetPredecessors() > 0) {
+            LOG_DEBUG(log, "Job " + to_string(job->getJobNumber()) + " waits for " + to_string(job->getUnmetPredecessors()) + " preceeding jobs [" + vtos(job->getPreceedingJobs()) + "].", 2);
+            this->dependentJobs.insert(job);
+            return;
+        }
+        this->jobEligible(job);
+    }
+
+    /*
+     * Makes a job that has arrived and has no unfinished preceeding jobs visible to the scheduling
+     * @param job The job
+     */
+    void SLURMSchedulingPolicy::jobEligible(Job* job) {
+        // The job ages from now, its key in the queues must be set before it is inserted
+        job->setslurmEligibleTime(this->globalTime);
+        if (this->priority->isEnabled())
+            job->setslurmFactors(this->priority->getFactors(job));
         //otherwise to the queue
         this->waitingQueue.insert(job);
     }
@@ -367,7 +434,7 @@ namespace Simulator {
             .diskBW = 0.0, .memBW = 0.0, .fabBW = 0.0
         };
 
-        std::deque<ResourceBucket*> allocations = alloc->getAllocations();
+        const std::vector<AvailabilityWindow>& candidates = alloc->getCandidates();
 
         ResourceJobAllocation *best = new ResourceJobAllocation();
         best->setStartTime(alloc->getStartTime());
@@ -375,20 +442,20 @@ namespace Simulator {
 
         std::deque<ResourceBucket*> bestBuckets;
 
-        for (uint32_t i = 0; i < allocations.size(); i++) {
+        for (uint32_t i = 0; i < candidates.size(); i++) {
 
             ReservationList rl = {0};
             bool reserve = false;
             uint32_t neededcpus = rr.cpus - avail.cpus;
 
-            if ((rr.cpusPerNode > allocations[i]->getFreeCPUs()) or
-                    (rr.memPerNode > allocations[i]->getFreeMemory()) or
-                    (rr.diskPerNode > allocations[i]->getFreeDisk())) continue;
+            if ((rr.cpusPerNode > candidates[i].freeCPUs) or
+                    (rr.memPerNode > candidates[i].freeMemory) or
+                    (rr.diskPerNode > candidates[i].freeDisk)) continue;
             if (neededcpus > 0) {
                 uint64_t memPerCore = job->getRequestedMemory();
-                uint32_t maxcpus = (rr.mem == 0) ? rr.cpus : allocations[i]->getFreeMemory() / memPerCore;
+                uint32_t maxcpus = (rr.mem == 0) ? rr.cpus : candidates[i].freeMemory / memPerCore;
                 //Memory is specified by processor. Therefore, free memory could limit the number of processors to reserve.
-                maxcpus = (maxcpus < allocations[i]->getFreeCPUs()) ? maxcpus : allocations[i]->getFreeCPUs();
+                maxcpus = (maxcpus < candidates[i].freeCPUs) ? maxcpus : candidates[i].freeCPUs;
 
                 uint32_t reserveCPUs = (neededcpus > maxcpus) ? maxcpus : neededcpus;
                 avail.cpus += reserveCPUs;
@@ -399,7 +466,7 @@ namespace Simulator {
             }
 
             if (avail.disk < rr.disk) {
-                uint64_t freedisk = allocations[i]->getFreeDisk();
+                uint64_t freedisk = candidates[i].freeDisk;
                 rl.disk = (rr.disk > freedisk) ? freedisk : rr.disk;
                 avail.disk += rl.disk;
 
@@ -407,8 +474,8 @@ namespace Simulator {
             }
 
             if (reserve) {
-                ResourceBucket *rb = new ResourceBucket(rl, allocations[i]->getStartTime(), allocations[i]->getEndTime());
-                rb->setID(allocations[i]->getID());
+                ResourceBucket *rb = new ResourceBucket(rl, candidates[i].startTime, candidates[i].endTime);
+                rb->setID(candidates[i].id);
                 bestBuckets.push_back(rb);
             }
 
@@ -420,6 +487,58 @@ namespace Simulator {
         return best;
     }
 
+    /**
+     * Checks if an allocation found before other jobs were scheduled may have changed because of them
+     * @param allocation The allocation, with the candidate nodes of the job
+     * @param takenNodes The earliest start time of the jobs scheduled since the allocation was found, on every node
+     * @return True if one of the candidate nodes has been taken before the end of the allocation
+     */
+    bool SLURMSchedulingPolicy::usesTakenNodes(ResourceJobAllocation* allocation, const map<uint32_t, double>& takenNodes) {
+        const std::vector<AvailabilityWindow>& candidates = allocation->getCandidates();
+        for (uint32_t i = 0; i < candidates.size(); i++) {
+            map<uint32_t, double>::const_iterator taken = takenNodes.find(candidates[i].id);
+            if (taken != takenNodes.end() && taken->second <= allocation->getEndTime())
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Records the nodes used by a job that has been scheduled
+     * @param allocation The allocation of the job
+     * @param takenNodes The earliest start time of the jobs scheduled on every node, it is updated
+     */
+    void SLURMSchedulingPolicy::takeNodes(ResourceJobAllocation* allocation, map<uint32_t, double>& takenNodes) {
+        std::deque<ResourceBucket*> buckets = allocation->getAllocations();
+        for (std::deque<ResourceBucket*>::iterator it = buckets.begin(); it != buckets.end(); ++it) {
+            map<uint32_t, double>::iterator taken = takenNodes.find((*it)->getID());
+            if (taken == takenNodes.end())
+                takenNodes[(*it)->getID()] = allocation->getStartTime();
+            else if (allocation->getStartTime() < taken->second)
+                taken->second = allocation->getStartTime();
+        }
+    }
+
+    /**
+     * The constructor for the class
+     * @param table The reservation table where the allocation is looked for
+     * @param job The job to allocate
+     * @param time The time when the job would start
+     */
+    SLURMAllocationSearch::SLURMAllocationSearch(ResourceReservationTable* table, Job* job, double time) {
+        this->table = table;
+        this->job = job;
+        this->time = time;
+        this->allocation = NULL;
+    }
+
+    /**
+     * Looks for the resources to start the job at the time during its requested time
+     */
+    void SLURMAllocationSearch::run() {
+        this->allocation = this->table->findPossibleAllocation(this->job, this->time, this->job->getRequestedTime());
+    }
+
     /**
      * Moves a job from the wait queue to the reservation table, using an specified set of resources
      * @see The class SchedulingPolicy
@@ -427,7 +546,7 @@ namespace Simulator {
      */
     void SLURMSchedulingPolicy::jobFinish(Job * job) {
 
-        log->debug("Finishing Job " + to_string(job->getJobNumber()) + " at globalTime: " + to_string((unsigned int) globalTime), 1);
+        LOG_DEBUG(log, "Finishing Job " + to_string(job->getJobNumber()) + " at globalTime: " + to_string((unsigned int) globalTime), 1);
 
         //We call to the base class - important it has to update some info
         SchedulingPolicy::jobFinish(job);
@@ -459,6 +578,23 @@ namespace Simulator {
         runningQueue.erase(job);
         finishedQueue.insert(job);
 
+        // The succeeding jobs that have arrived and were only waiting for this one can be scheduled now
+        for (vector<Job*>::iterator it = job->getSuccessors().begin(); it != job->getSuccessors().end(); ++it) {
+            Job* successor = *it;
+            successor->setUnmetPredecessors(successor->getUnmetPredecessors() - 1);
+            assert(successor->getUnmetPredecessors() >= 0);
+            if (successor->getUnmetPredecessors() == 0 and this->dependentJobs.erase(successor)) {
+                LOG_DEBUG(log, "Job " + to_string(successor->getJobNumber()) + " has all its preceeding jobs COMPLETED.", 2);
+                this->jobEligible(successor);
+            }
+        }
+
+        // The user stops being charged, the priority of its pending jobs changes
+        if (this->priority->isEnabled()) {
+            this->priority->jobFinish(job, globalTime);
+            this->reprioritizeJobs(job->getUserID());
+        }
+
         //lastAllowedStartTime = globalTime;
         this->sim->simInsertScheduleEvent();
         this->skip_backfill = false;
@@ -485,17 +621,17 @@ namespace Simulator {
 
 
 
-        this->log->debug("Job " + to_string(job->getJobNumber()) + " scheduled to start @ " + ftos(allocation->getStartTime()), 2);
-        this->log->debug("Job " + to_string(job->getJobNumber()) + " runtime = " + to_string(job->getRunTime()) + " requested time = " + to_string(job->getRequestedTime()), 8);
+        LOG_DEBUG(this->log, "Job " + to_string(job->getJobNumber()) + " scheduled to start @ " + ftos(allocation->getStartTime()), 2);
+        LOG_DEBUG(this->log, "Job " + to_string(job->getJobNumber()) + " runtime = " + to_string(job->getRunTime()) + " requested time = " + to_string(job->getRequestedTime()), 8);
         // Insert JOB_START event
         this->sim->simInsertJobStartEvent(job);
         // Insert JOB_FINSH event
         this->sim->simInsertJobFinishEvent(job);
 
         if (this->persist == AVAILABLE && job->getworkflowStatus() == 2) {
-            log->debug("Job " + to_string(job->getJobNumber()) + " skipping IO events due to workflowyness.");
+            LOG_DEBUG(log, "Job " + to_string(job->getJobNumber()) + " skipping IO events due to workflowyness.", 1);
         } else {
-            log->debug("Job " + to_string(job->getJobNumber()) + " adding IO events.");
+            LOG_DEBUG(log, "Job " + to_string(job->getJobNumber()) + " adding IO events.", 1);
             this->sim->simInsertComputeBeginEvent(job);
             this->sim->simInsertComputeEndEvent(job);
         }
@@ -506,6 +642,33 @@ namespace Simulator {
 
     }
 
+    /*
+     * Recomputes the multifactor priority of the pending jobs of a user after its fair-share factor has changed.
+     * The priority is part of the key of the queues, so the jobs are taken out of them while it changes.
+     * @param user The user
+     */
+    void SLURMSchedulingPolicy::reprioritizeJobs(int user) {
+        set<Job*>& jobs = this->pendingJobs[user];
+        for (set<Job*>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+            Job* job = *it;
+            double factors = this->priority->getFactors(job);
+            if (factors == job->getslurmFactors())
+                continue;
+            bool waiting = this->waitingQueue.contains(job);
+            bool scheduled = this->scheduledQueue.contains(job);
+            if (waiting)
+                this->waitingQueue.erase(job);
+            if (scheduled)
+                this->scheduledQueue.erase(job);
+            job->setslurmFactors(factors);
+            if (waiting)
+                this->waitingQueue.insert(job);
+            if (scheduled)
+                this->scheduledQueue.insert(job);
+        }
+        LOG_DEBUG(log, "Fair-share of user " + to_string(user) + " is " + ftos(this->priority->getFairShare(user)) + ", " + to_string(jobs.size()) + " pending jobs", 4);
+    }
+
     /**
      * Chooses the more appropiate job to run .
      * @see The class SchedulingPolicy
@@ -524,10 +687,16 @@ namespace Simulator {
          */
         this->runningQueue.insert(job);
         this->scheduledQueue.erase(job);
+        // The user starts being charged, the priority of its pending jobs changes
+        if (this->priority->isEnabled()) {
+            this->pendingJobs[job->getUserID()].erase(job);
+            this->priority->jobStart(job, globalTime);
+            this->reprioritizeJobs(job->getUserID());
+        }
         ResourceJobAllocation* allocation = ((ResourceReservationTable*)this->reservationTable)->getJobAllocation(job);
         deque<ResourceBucket*> allocs = allocation->getAllocations();
         if (this->outputTrace) {
-            log->debug("Pushing " + to_string(allocs.size()) + " buckets to output Trace handler.", 4);
+            LOG_DEBUG(log, "Pushing " + to_string(allocs.size()) + " buckets to output Trace handler.", 4);
             if (this->persist == AVAILABLE && job->getworkflowStatus() == 2){
                 this->opTrace->jobStart(job->getJobNumber(), allocs, true);
             } else {
@@ -535,6 +704,9 @@ namespace Simulator {
             }
         }
         this->skip_backfill = false;
+        // Only the succeeding jobs of a workflow ask for the nodes of a job
+        if (job->getSuccessors().empty())
+            return;
         std::vector<uint32_t> nnodes;
         ResourceBucket* current;
         for (deque<ResourceBucket*>::iterator alloc_it = allocs.begin(); alloc_it != allocs.end(); ++alloc_it) {
@@ -542,7 +714,7 @@ namespace Simulator {
             uint32_t bId = current->getID();
             nnodes.push_back(bId);
         }
-        this->jobnodes.insert(std::pair<uint32_t, std::vector < uint32_t >> ((uint32_t) job->getJobNumber(), nnodes));
+        this->jobnodes.insert(std::pair<Job*, std::vector < uint32_t >> (job, nnodes));
 
     }
 
@@ -592,7 +764,15 @@ namespace Simulator {
         return this->waitingQueue.size();
     }
 
-    ResourceJobAllocation* SLURMSchedulingPolicy::findFutureAllocation(Job* job, double startTime, double runtime) {
+    /*
+     * Finds the earliest allocation of a job from a given time
+     * @param job The job
+     * @param startTime The first time that can be used
+     * @param runtime The runtime of the job
+     * @param resolution If it is not 0 the start times tried are the ones every resolution seconds from now, like bf_resolution in SLURM
+     * @return The allocation
+     */
+    ResourceJobAllocation* SLURMSchedulingPolicy::findFutureAllocation(Job* job, double startTime, double runtime, double resolution) {
         bool allocated = false;
 
         while (!allocated) {
@@ -601,6 +781,10 @@ namespace Simulator {
             if (this->persist == AVAILABLE){
                 _nodes = getPreceedingNodes(job);
             }
+            //the nodes are only explored once the whole system has enough free resources for the job
+            startTime = ((ResourceReservationTable*)this->reservationTable)->findEarliestStart(job, startTime, runtime);
+            if (resolution > 0)
+                startTime = this->globalTime + ceil((startTime - this->globalTime) / resolution) * resolution;
             ResourceJobAllocation* possibleAllocation = ((ResourceReservationTable*)this->reservationTable)->findPossibleAllocation(job, startTime, runtime, _nodes);
 
             //TODO: This has been oversimplified. Check how to go back to add different policies and act accordingly.
@@ -632,16 +816,17 @@ namespace Simulator {
     }
 
     vector<uint32_t> SLURMSchedulingPolicy::getPreceedingNodes(Job* job) {
-        vector<int> _pj = job->getPreceedingJobs();
+        vector<Job*>& _pj = job->getPredecessors();
         vector<uint32_t> _nodes;
-        vector<uint32_t> _nn;
 
 
         if (_pj.empty() == false) {
-            for (vector<int>::iterator _pj_it = _pj.begin(); _pj_it != _pj.end(); _pj_it++) {
-                std::map<uint32_t, std::vector<uint32_t> > ::iterator iter = this->jobnodes.find(uint32_t(*_pj_it));
-                _nn = iter->second;
-                _nodes.insert(_nodes.end(), _nn.begin(), _nn.end());
+            for (vector<Job*>::iterator _pj_it = _pj.begin(); _pj_it != _pj.end(); _pj_it++) {
+                // A preceeding job that has not started yet has no nodes
+                std::map<Job*, std::vector<uint32_t> > ::iterator iter = this->jobnodes.find(*_pj_it);
+                if (iter == this->jobnodes.end())
+                    continue;
+                _nodes.insert(_nodes.end(), iter->second.begin(), iter->second.end());
             }
         }
         sort(_nodes.begin(), _nodes.end());
@@ -661,14 +846,14 @@ namespace Simulator {
     }
 
     void SLURMSchedulingPolicy::jobTransitionToCompute(Job* job) {
-        log->debug("SLURMSchedulingPolicy::jobTransitionToCompute for the job " + to_string(job->getJobNumber()), 2);
+        LOG_DEBUG(log, "SLURMSchedulingPolicy::jobTransitionToCompute for the job " + to_string(job->getJobNumber()), 2);
         if (this->outputTrace) {
             this->opTrace->jobBeginCompute(job->getJobNumber());
         }
     }
 
     void SLURMSchedulingPolicy::jobTransitionToOutput(Job* job) {
-        log->debug("SLURMSchedulingPolicy::jobTransitionToOutput for the job " + to_string(job->getJobNumber()), 2);
+        LOG_DEBUG(log, "SLURMSchedulingPolicy::jobTransitionToOutput for the job " + to_string(job->getJobNumber()), 2);
         if (this->outputTrace) {
             this->opTrace->jobEndCompute(job->getJobNumber());
         }
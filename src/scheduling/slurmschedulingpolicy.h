@@ -23,9 +23,11 @@
 
 #include <scheduling/schedulingpolicy.h>
 #include <scheduling/resourcereservationtable.h>
+#include <scheduling/slurmpriority.h>
 #include <utils/slurmjobqueue.h>
 #include <utils/estimatefinishjobqueue.h>
 #include <utils/realfinishjobqueue.h>
+#include <utils/threadpool.h>
 
 using std::vector;
 using std::map;
@@ -40,6 +42,24 @@ namespace Simulator {
 
     typedef pair <int, Job*> pairJob;
 
+    /** The candidates that the backfill checks at once for every thread, when it runs with more than one */
+#define SLURM_BACKFILL_JOBS_PER_THREAD 4
+
+    /**
+     * Checks if a job can start at a given time in the reservation table. The backfill runs a window of them at once, while
+     * the table is not modified, so they only read it.
+     */
+    class SLURMAllocationSearch : public Utils::ThreadPoolTask {
+    public:
+        SLURMAllocationSearch(ResourceReservationTable* table, Job* job, double time);
+        void run() override;
+
+        ResourceReservationTable* table; /**< The reservation table where the allocation is looked for */
+        Job* job; /**< The job to allocate */
+        double time; /**< The time when the job would start */
+        ResourceJobAllocation* allocation; /**< The allocation found, NULL until the search has run */
+    };
+
     /**
      * This class implements a scheduling policy that mimics the one used in SLURM.
      * See the super-class schedulingpolicy too.
@@ -68,11 +88,15 @@ namespace Simulator {
 
     private:
         ResourceJobAllocation* findBestAllocation(Job *job, ResourceJobAllocation* alloc);
-        ResourceJobAllocation* findFutureAllocation(Job* job, double startTime, double runtime);
+        ResourceJobAllocation* findFutureAllocation(Job* job, double startTime, double runtime, double resolution = 0);
         ResourceJobAllocation* findNowAllocation(Job* job, double startTime, double runtime);
         vector<uint32_t> getPreceedingNodes(Job* job);
         
         void scheduleJob(Job* job, ResourceJobAllocation* allocation);
+        void reprioritizeJobs(int user);
+        void jobEligible(Job* job);
+        bool usesTakenNodes(ResourceJobAllocation* allocation, const map<uint32_t, double>& takenNodes);
+        void takeNodes(ResourceJobAllocation* allocation, map<uint32_t, double>& takenNodes);
         /*
          * This nomenclature is dumb.
          * What I need is:
@@ -102,7 +126,11 @@ namespace Simulator {
         double lastscheduletime; // When was the last time the schedule function ran - as to suppress multiple runs in a short period to mimic SLURM.
         int bf_counter; // Temp counter to ensure running back on Nth run of SCHEDULE.
         bool skip_backfill;
-        map<uint32_t, vector<uint32_t> > jobnodes;
+        map<Job*, vector<uint32_t> > jobnodes; /**< The nodes where the jobs with succeeding jobs have run */
+        set<Job*> dependentJobs; /**< Jobs that have arrived but wait for their preceeding jobs to finish */
+        SLURMPriority* priority; /**< The multifactor priority engine, it is only used when it is enabled */
+        map<int, set<Job*> > pendingJobs; /**< The jobs of every user that have not started yet, for the multifactor priority */
+        Utils::ThreadPool* backfillPool; /**< The threads that check if the backfill candidates can start now */
         enum slurm_persistent_memory persist;
 
     };
@@ -26,13 +26,40 @@
 #include <scheduling/resourceschedulingpolicy.h>
 #include <scheduling/resourcereservationtable.h>
 #include <archdatamodel/node.h>
+#include <scheduling/simulation.h>
 #include <utils/log.h>
+#include <utils/threadpool.h>
 #include <cassert>
 #include <iostream>
 #include <cmath> //Needed for INFINITY macaro
 
 namespace Simulator {
 
+    /**
+     * Runs a schedule or backfill pass of a partition in a thread of the pool. The event operations of the pass are kept
+     * in the task until all the partitions have finished.
+     */
+    class PartitionScheduleTask : public Utils::ThreadPoolTask {
+    public:
+
+        PartitionScheduleTask(Partition* partition, Simulation* sim, bool backfill) : partition(partition), sim(sim), backfill(backfill) {
+        }
+
+        void run() override {
+            this->sim->deferEvents(&this->events);
+            if (this->backfill)
+                this->partition->backfill();
+            else
+                this->partition->schedule();
+            this->sim->deferEvents(NULL);
+        }
+
+        Partition* partition; /**< The partition to schedule */
+        Simulation* sim; /**< The simulation where the events go */
+        bool backfill; /**< True for a backfill pass, false for a schedule pass */
+        vector<DeferredEvent> events; /**< The event operations of the pass, in order */
+    };
+
     SystemOrchestrator::SystemOrchestrator(Utils::ArchitectureConfiguration *archConf, double startTime, Utils::Log* log) {
         this->archConf = archConf;
         this->log = log;
@@ -40,11 +67,26 @@ namespace Simulator {
         //        cout << "SysOrch::SysOrch constructor calling to create a new RRT" << endl;
         this->rt = new ResourceReservationTable(log, this->globalTime);
         this->simulatePartitions = false;
+        this->partitionPool = NULL;
         this->reserveFullNode = false;
         this->policy = NULL;
         this->generateOutputTrace = false; // Store this here for ease, can be had from archconf via simconfig too
     }
 
+    /**
+     * The destructor for the class. The policies free their reservation tables. The tables of the partitions can be views
+     * over the store of the table of the orchestrator, so the partitions go first.
+     */
+    SystemOrchestrator::~SystemOrchestrator() {
+        for (uint32_t i = 0; i < partitions.size(); i++)
+            delete partitions[i];
+        if (policy != NULL)
+            delete policy;
+        else
+            delete rt;
+        delete partitionPool;
+    }
+
     void SystemOrchestrator::setPolicy(ResourceSchedulingPolicy *policy) {
         this->policy = policy;
         this->policyType = policy->getschedulingPolicySimulated();
@@ -83,7 +125,7 @@ namespace Simulator {
     void SystemOrchestrator::createPartitions(std::vector<ArchDataModel::PartitionList*> partitionlists) {
 
         for (uint32_t pl = 0; pl < partitionlists.size(); pl++) {
-            Simulator::Partition *p = new Simulator::Partition(startTime, log);
+            Simulator::Partition *p = new Simulator::Partition(startTime, log, rt->getTimelineStore());
             addPartition(p);
             std::vector<ArchDataModel::Node*> nodes = partitionlists[pl]->getNodesInPartitionList();
 
@@ -95,7 +137,7 @@ namespace Simulator {
                  * It would simplify things. A lot.
                  */
                 rt->addNode(nodes[n]); // Add the nodes to the SysOrch RRT
-                p->addNode(nodes[n]); // This will internally add the nodes to the individual partition's RRT
+                p->addNode(nodes[n]); // The partition's RRT is a view over the same store, the node keeps the timeline just created
             }
         }
         // A Testing cheat, if only 1 P, just abuse its RRT as the system one.
@@ -111,7 +153,7 @@ namespace Simulator {
         switch (pType) {
             case FCFS:
             {
-                log->debug("Creating a FCFS policy with no resource usage modelling.", 1);
+                LOG_DEBUG(log, "Creating a FCFS policy with no resource usage modelling.", 1);
                 //TODO: Use simulateResourceUsage
                 bool simulateResourceUsage = false;
                 int numberOfReservations = this->policy->numberOfReservations;
@@ -126,7 +168,7 @@ namespace Simulator {
             }
             case SLURM:
             {
-                log->debug("Creating a SLURM policy with no resource usage modelling.", 1);
+                LOG_DEBUG(log, "Creating a SLURM policy with no resource usage modelling.", 1);
                 bool simulateResourceUsage = false;
                 int numberOfReservations = this->policy->numberOfReservations;
                 bool malexpand = this->policy->malleableExpand;
@@ -190,15 +232,24 @@ namespace Simulator {
         return NULL;
     }
 
-    Partition *SystemOrchestrator::selectPartition(Job *job) {
+    /**
+     * Returns the index of the partition where a job is sent
+     * @param job The job
+     * @return The index of its partition, the first one if the job does not request any
+     */
+    uint32_t SystemOrchestrator::getPartitionIndex(Job *job) {
         if (job->getPartitionNumber() != -1) {
             int partNum = job->getPartitionNumber();
-            return partitions[partNum - 1];
+            return partNum - 1;
         } else {
-            return partitions[0];
+            return 0;
         }
     }
 
+    Partition *SystemOrchestrator::selectPartition(Job *job) {
+        return partitions[getPartitionIndex(job)];
+    }
+
     //Scheduling related functions
 
     void SystemOrchestrator::arrival(Job *job) {
@@ -223,6 +274,8 @@ namespace Simulator {
     void SystemOrchestrator::schedule() {
         if (!simulatePartitions) {
             policy->schedule();
+        } else if (partitionPool != NULL) {
+            schedulePartitionsAtOnce(false);
         } else {
             for (uint32_t i = 0; i < partitions.size(); i++) {
                 partitions[i]->schedule();
@@ -234,6 +287,8 @@ namespace Simulator {
     void SystemOrchestrator::backfill() {
         if (!simulatePartitions) {
             policy->backfill();
+        } else if (partitionPool != NULL) {
+            schedulePartitionsAtOnce(true);
         } else {
             for (uint32_t i = 0; i < partitions.size(); i++) {
                 partitions[i]->backfill();
@@ -241,6 +296,27 @@ namespace Simulator {
         }
     }
 
+    /**
+     * Schedules all the partitions at once in the thread pool. The partitions do not share any state but the simulation,
+     * whose event operations are deferred and then applied partition by partition, in the same order as when they are
+     * scheduled one after the other, so the events and their ids are the same. The log serialises the messages of the
+     * threads, so only the order of the debug lines of different partitions may change.
+     * @param backfill True for a backfill pass, false for a schedule pass
+     */
+    void SystemOrchestrator::schedulePartitionsAtOnce(bool backfill) {
+        vector<PartitionScheduleTask> tasks;
+        vector<Utils::ThreadPoolTask*> pending;
+        tasks.reserve(partitions.size());
+        for (uint32_t i = 0; i < partitions.size(); i++) {
+            tasks.push_back(PartitionScheduleTask(partitions[i], sim, backfill));
+            pending.push_back(&tasks.back());
+        }
+        partitionPool->run(pending);
+
+        for (uint32_t i = 0; i < tasks.size(); i++)
+            sim->applyDeferredEvents(tasks[i].events);
+    }
+
     void SystemOrchestrator::termination(Job *job) {
         if (!simulatePartitions) {
             policy->jobFinish(job);
@@ -289,16 +365,62 @@ namespace Simulator {
 
     void SystemOrchestrator::setReserveFullNode(bool rfn) {
         reserveFullNode = rfn;
+        // The partitions' RRTs share the store of the SysOrch RRT, so they see the setting as well
+        rt->setReserveFullNode(rfn);
+        // unless they have stores of their own
+        if (partitionPool != NULL)
+            for (uint32_t i = 0; i < partitions.size(); i++)
+                partitions[i]->getReservationTable()->setReserveFullNode(rfn);
     }
 
     bool SystemOrchestrator::getReserveFullNode() {
         return this->reserveFullNode;
     }
 
+    void SystemOrchestrator::setNodePools(bool nodePools) {
+        // The partitions' RRTs share the store of the SysOrch RRT, so they see the setting as well
+        rt->setNodePools(nodePools);
+        // unless they have stores of their own
+        if (partitionPool != NULL)
+            for (uint32_t i = 0; i < partitions.size(); i++)
+                partitions[i]->getReservationTable()->setNodePools(nodePools);
+    }
+
+    void SystemOrchestrator::setEarliestStartSearch(bool earliestStartSearch) {
+        // The partitions' RRTs share the store of the SysOrch RRT, so they see the setting as well
+        rt->setEarliestStartSearch(earliestStartSearch);
+        // unless they have stores of their own
+        if (partitionPool != NULL)
+            for (uint32_t i = 0; i < partitions.size(); i++)
+                partitions[i]->getReservationTable()->setEarliestStartSearch(earliestStartSearch);
+    }
+
     void SystemOrchestrator::setSimulatePartitions(bool simp) {
         simulatePartitions = simp;
     }
 
+    /**
+     * Sets the threads that schedule the partitions at once. With more than one every partition moves its nodes to a store
+     * of its own, as the partitions do not share nodes, so it has to be called once the partitions are created and before
+     * the policy is set. The shared store would not see the reservations of the partitions anymore, so it is deleted with
+     * the table of the orchestrator, which is left without nodes: only the partitions can tell the state of the nodes.
+     * @param threads The number of threads, with one the partitions are scheduled one after the other
+     */
+    void SystemOrchestrator::setPartitionThreads(uint32_t threads) {
+        assert(policy == NULL and partitionPool == NULL);
+        if (!simulatePartitions or threads < 2 or partitions.size() < 2)
+            return;
+        for (uint32_t i = 0; i < partitions.size(); i++)
+            partitions[i]->separateStore(globalTime);
+        delete rt;
+        rt = new ResourceReservationTable(log, globalTime);
+        partitionPool = new Utils::ThreadPool(threads);
+    }
+
+    Utils::ThreadPool *SystemOrchestrator::getPartitionPool() {
+        return partitionPool;
+    }
+
     void SystemOrchestrator::setOutputTrace(bool theValue) {
         this->generateOutputTrace = theValue;
     }
@@ -39,6 +39,7 @@ namespace Simulator {
 
 namespace Utils {
 	class ArchitectureConfiguration;
+	class ThreadPool;
 	class Log;
 	class ConfigurationFile;
         class SimulationConfiguration;
@@ -68,7 +69,7 @@ class ArchitectureConfiguration;
 class SystemOrchestrator {
 public:
 	SystemOrchestrator(Utils::ArchitectureConfiguration *archConf, double startTime, Utils::Log* log=NULL);
-	~SystemOrchestrator();
+	virtual ~SystemOrchestrator();
 	
 	void setPolicy(ResourceSchedulingPolicy *policy);
 	ResourceSchedulingPolicy *getPolicy();
@@ -86,6 +87,7 @@ public:
 	void addPartition(Partition *p);
 	Partition *getPartition(uint32_t id);
 	Partition *getPartition(std::string id);
+	uint32_t getPartitionIndex(Job *job);
 	
 	//Scheduling related functions
 	void arrival(Job* job);
@@ -103,8 +105,12 @@ public:
 	//Sim related functions
 	virtual void setSim(Simulation* theValue);
 	void setSimulatePartitions(bool simp);
+	void setPartitionThreads(uint32_t threads);
+	Utils::ThreadPool *getPartitionPool();
 	void setReserveFullNode(bool rfn);
         bool getReserveFullNode();
+        void setNodePools(bool nodePools);
+        void setEarliestStartSearch(bool earliestStartSearch);
         
         // Tracing Options
         void setOutputTrace(bool theValue);
@@ -116,6 +122,7 @@ public:
 private:
 	ResourceSchedulingPolicy *createPolicy(Utils::policy_type_t pType, RS_policy_type_t rspType, double startTime, Utils::Log *log);
 	Partition *selectPartition(Job *job);
+	void schedulePartitionsAtOnce(bool backfill);
 
 	std::vector<ArchDataModel::Node*> nodes;
 	
@@ -124,6 +131,7 @@ private:
         bool generateOutputTrace;
 
 	std::vector<Partition*> partitions; /**< Vector with all the partitions defined.*/
+	Utils::ThreadPool *partitionPool; /**< The threads that schedule the partitions at once, NULL if they are scheduled one after the other.*/
 	std::map<Job*,Partition*> job2part; /**< A Map to know to which partition a job was sent.*/
 	ResourceSchedulingPolicy *policy; /**< Policy used to schedule jobs */
 	
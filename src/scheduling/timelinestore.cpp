@@ -0,0 +1,630 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <scheduling/timelinestore.h>
+#include <utils/log.h>
+#include <archdatamodel/node.h>
+
+#include <assert.h>
+
+using namespace std;
+
+namespace Simulator {
+
+    /**
+     * The constructor for the class
+     * @param startTime The time when the store is created, the timelines begin at it
+     * @param log A reference to the logging engine
+     */
+    TimelineStore::TimelineStore(double startTime, Utils::Log* log) : freeNodeIndex(startTime) {
+        this->log = log;
+        this->startTime = startTime;
+        this->nodePools = false;
+        this->reserveFullNode = false;
+        this->earliestStartSearch = false;
+        this->nextTrimmedPool = 0;
+        this->lastTrimTime = startTime;
+        this->overlay = false;
+    }
+
+    /**
+     * The destructor for the class
+     */
+    TimelineStore::~TimelineStore() {
+    }
+
+    /**
+     * Creates a view without nodes, the nodes are added to it with addNode
+     * @param startTime The time when the view is created, its capacity profile begins at it
+     * @return The view
+     */
+    uint32_t TimelineStore::addView(double startTime) {
+        this->views.push_back(TimelineView(startTime));
+        return this->views.size() - 1;
+    }
+
+    /**
+     * Adds a node to a view. The node gets a timeline the first time that it is added to the store, when it is added by
+     * another view it keeps the timeline that it already has. The nodes of a view have to be consecutive in the store.
+     * @param view The view
+     * @param node The node
+     * @param startTime The time when the node is added, its timeline begins at it
+     * @return The id of the node in the store
+     */
+    uint32_t TimelineStore::addNode(uint32_t view, ArchDataModel::Node* node, double startTime) {
+        assert(view < this->views.size());
+        uint32_t id;
+        map<ArchDataModel::Node*, uint32_t>::iterator it = this->nodeIds.find(node);
+        if (it != this->nodeIds.end()) {
+            id = it->second;
+        } else {
+            id = this->nodes.size();
+            this->nodes.push_back(node);
+            this->nodeIds.insert(std::pair<ArchDataModel::Node*, uint32_t>(node, id));
+            this->nodePool.push_back(this->newPool(NodeTimeline(node, startTime)));
+            this->attachNode(id);
+            this->freeNodeIndex.addNode();
+            if (this->reserveFullNode) {
+                const vector<TimelineSegment>& segments = this->getTimeline(id).getSegments();
+                this->freeNodeIndex.update(id, segments.front().startTime, segments.back().startTime, this->getTimeline(id), node->getNumberCPUs());
+            }
+        }
+
+        TimelineView& current = this->views[view];
+        if (current.numberOfNodes == 0)
+            current.firstNode = id;
+        assert(id == current.firstNode + current.numberOfNodes);
+        current.numberOfNodes++;
+        current.capacity.addCapacity(node->getNumberCPUs(), node->getMemorySize());
+        return id;
+    }
+
+    /**
+     * Returns the id in the store of the first node of a view
+     * @param view The view
+     * @return The id of the first node
+     */
+    uint32_t TimelineStore::getFirstNode(uint32_t view) const {
+        return this->views[view].firstNode;
+    }
+
+    /**
+     * Returns the number of nodes of a view
+     * @param view The view
+     * @return The number of nodes
+     */
+    uint32_t TimelineStore::getNumberOfNodes(uint32_t view) const {
+        return this->views[view].numberOfNodes;
+    }
+
+    /**
+     * Returns the version of a view, it changes every time that the timeline of any of its nodes changes outside an
+     * overlay or when an overlay that changed it is committed. It tells the policies if the view is as they left it.
+     * @param view The view
+     * @return The version of the view
+     */
+    uint64_t TimelineStore::getVersion(uint32_t view) const {
+        return this->views[view].version;
+    }
+
+    /**
+     * Returns a node of the store
+     * @param id The id of the node in the store
+     * @return The node
+     */
+    ArchDataModel::Node* TimelineStore::getNode(uint32_t id) const {
+        return this->nodes[id];
+    }
+
+    /**
+     * Returns the timeline of a node, which is shared with the rest of nodes of its pool
+     * @param id The id of the node in the store
+     * @return A reference to the timeline of the node
+     */
+    const NodeTimeline& TimelineStore::getTimeline(uint32_t id) const {
+        if (this->overlay) {
+            map<uint32_t, NodeTimeline>::const_iterator it = this->overlayTimelines.find(id);
+            if (it != this->overlayTimelines.end())
+                return it->second;
+        }
+        return this->timeline[this->nodePool[id]];
+    }
+
+    /**
+     * Sets if the nodes with the same state share their timeline. With thousands of identical nodes most of them
+     * are in the same state, so the store keeps a pool of nodes per different timeline. A pool is split when a
+     * reservation or a release touches only some of its nodes, and the nodes join again when their timelines become
+     * the same. The scheduling is exactly the same with or without pools.
+     * @param nodePools True to group the nodes in pools, false to keep a timeline per node
+     */
+    void TimelineStore::setNodePools(bool nodePools) {
+        assert(not this->overlay);
+        if (nodePools == this->nodePools)
+            return;
+
+        if (nodePools) {
+            this->nodePools = true;
+            for (uint32_t id = 0; id < this->nodes.size(); id++)
+                this->attachNode(id);
+        } else {
+            for (uint32_t id = 0; id < this->nodes.size(); id++)
+                this->detachNode(id);
+            this->poolIndex.clear();
+            this->nodePools = false;
+        }
+        LOG_DEBUG(log, "Node pools " + string(nodePools ? "enabled" : "disabled") + ", " + to_string(this->getNumberOfPools()) + " pools for " + to_string(this->nodes.size()) + " nodes", 2);
+    }
+
+    /**
+     * Returns if the nodes with the same state share their timeline
+     * @return True if the nodes are grouped in pools
+     */
+    bool TimelineStore::getNodePools() const {
+        return this->nodePools;
+    }
+
+    /**
+     * Returns the number of pools in use, the number of different timelines of the store
+     * @return The number of pools
+     */
+    uint32_t TimelineStore::getNumberOfPools() const {
+        return this->timeline.size() - this->unusedPools.size();
+    }
+
+    /**
+     * Sets if the jobs only reserve full nodes. In that case the store keeps an index of the nodes that are completely
+     * free along the time, which is built from the timelines when it is enabled.
+     * @param reserveFullNode True if the jobs reserve full nodes
+     */
+    void TimelineStore::setReserveFullNode(bool reserveFullNode) {
+        assert(not this->overlay);
+        if (reserveFullNode == this->reserveFullNode)
+            return;
+        this->reserveFullNode = reserveFullNode;
+        if (not reserveFullNode)
+            return;
+
+        double startTime = this->nodes.empty() ? this->lastTrimTime : this->getTimeline(0).getSegments().front().startTime;
+        this->freeNodeIndex = FreeNodeIndex(startTime);
+        for (uint32_t id = 0; id < this->nodes.size(); id++)
+            this->freeNodeIndex.addNode();
+        for (uint32_t id = 0; id < this->nodes.size(); id++) {
+            const vector<TimelineSegment>& segments = this->getTimeline(id).getSegments();
+            this->freeNodeIndex.update(id, segments.front().startTime, segments.back().startTime, this->getTimeline(id), this->nodes[id]->getNumberCPUs());
+        }
+    }
+
+    /**
+     * Returns if the jobs only reserve full nodes
+     * @return True if the jobs reserve full nodes
+     */
+    bool TimelineStore::getReserveFullNode() const {
+        return this->reserveFullNode;
+    }
+
+    /**
+     * Sets if the allocation searches jump to the first time when the nodes of the view together have the resources
+     * of the job. The per-node search explores the next release of the nodes as the next time to try, which can be
+     * later than the first time when the job fits, so with the jump some jobs start earlier and the schedules change.
+     * The capacity profiles are kept in any case, the setting can be changed at any time.
+     * @param earliestStartSearch True to use the capacity profiles in the searches
+     */
+    void TimelineStore::setEarliestStartSearch(bool earliestStartSearch) {
+        this->earliestStartSearch = earliestStartSearch;
+    }
+
+    /**
+     * Returns if the allocation searches jump to the first time when the nodes of the view together have the resources
+     * @return True if the capacity profiles are used in the searches
+     */
+    bool TimelineStore::getEarliestStartSearch() const {
+        return this->earliestStartSearch;
+    }
+
+    /**
+     * Returns the index of the nodes that are completely free along the time, it is only kept when reserveFullNode is set
+     * @return A reference to the free node index, by id in the store
+     */
+    const FreeNodeIndex& TimelineStore::getFreeNodeIndex() const {
+        return this->freeNodeIndex;
+    }
+
+    /**
+     * Reserves resources in the timeline of a node and updates the indexes of the store and of every view that contains the node.
+     * With the overlay open the reservation is done in the copy of the timeline.
+     * @param id The id in the store of the node where the resources are reserved
+     * @param startTime The first time of the reservation
+     * @param endTime The last time of the reservation
+     * @param rl The resources to reserve
+     */
+    void TimelineStore::reserve(uint32_t id, double startTime, double endTime, const ReservationList& rl) {
+        assert(id < this->nodes.size());
+        if (this->overlay) {
+            this->getOverlayTimeline(id).reserve(startTime, endTime, rl);
+        } else {
+            uint32_t pool = this->detachNode(id);
+            this->timeline[pool].reserve(startTime, endTime, rl);
+            this->attachNode(id);
+        }
+
+        this->changeCapacity(id, startTime, endTime, rl.cpus, rl.mem, true);
+        if (this->reserveFullNode)
+            this->freeNodeIndex.update(id, startTime, endTime, this->getTimeline(id), this->nodes[id]->getNumberCPUs());
+    }
+
+    /**
+     * Gives back resources reserved with reserve and updates the indexes of the store and of every view that contains the node.
+     * With the overlay open the resources are given back in the copy of the timeline.
+     * @param id The id in the store of the node where the resources were reserved
+     * @param startTime The first time of the reservation
+     * @param endTime The last time of the reservation
+     * @param rl The resources that were reserved
+     */
+    void TimelineStore::release(uint32_t id, double startTime, double endTime, const ReservationList& rl) {
+        assert(id < this->nodes.size());
+        if (this->overlay) {
+            this->getOverlayTimeline(id).release(startTime, endTime, rl);
+        } else {
+            uint32_t pool = this->detachNode(id);
+            this->timeline[pool].release(startTime, endTime, rl);
+            this->attachNode(id);
+        }
+
+        this->changeCapacity(id, startTime, endTime, rl.cpus, rl.mem, false);
+        if (this->reserveFullNode)
+            this->freeNodeIndex.update(id, startTime, endTime, this->getTimeline(id), this->nodes[id]->getNumberCPUs());
+    }
+
+    /**
+     * Reserves or releases resources in the capacity profiles of the views that contain a node. The change is
+     * kept while the overlay is open, so it can be undone if the overlay is discarded.
+     * @param id The id in the store of the node
+     * @param startTime The first time of the change
+     * @param endTime The last time of the change
+     * @param cpus The cpus reserved or released
+     * @param memory The memory reserved or released
+     * @param reserve True to reserve, false to release
+     */
+    void TimelineStore::changeCapacity(uint32_t id, double startTime, double endTime, uint32_t cpus, uint64_t memory, bool reserve) {
+        for (vector<TimelineView>::iterator it = this->views.begin(); it != this->views.end(); ++it) {
+            if (id < it->firstNode or id >= it->firstNode + it->numberOfNodes)
+                continue;
+            if (reserve)
+                it->capacity.reserve(startTime, endTime, cpus, memory);
+            else
+                it->capacity.release(startTime, endTime, cpus, memory);
+        }
+
+        if (this->overlay) {
+            OverlayChange change = {.node = id, .startTime = startTime, .endTime = endTime, .cpus = cpus, .memory = memory, .reserve = reserve};
+            this->overlayChanges.push_back(change);
+        } else {
+            this->changeVersion(id);
+        }
+    }
+
+    /**
+     * Changes the version of the views that contain a node, after its timeline has changed
+     * @param id The id in the store of the node
+     */
+    void TimelineStore::changeVersion(uint32_t id) {
+        for (vector<TimelineView>::iterator it = this->views.begin(); it != this->views.end(); ++it)
+            if (id >= it->firstNode and id < it->firstNode + it->numberOfNodes)
+                it->version++;
+    }
+
+    /**
+     * This function returns the window of the specified node that starts at time and lasts runtime, with the
+     * common minimum of the free resources of the segments it overlaps. The window is computed on the stack.
+     *
+     * @param time The start time from when the job has to start to explore
+     * @param runtime The minimum length required for the window
+     * @param id The id in the store of the node where the window has to be found
+     * @return The window that matches the criteria, its id is the id of the node in the store
+     */
+    AvailabilityWindow TimelineStore::findFirstWindow(double time, double runtime, uint32_t id) const {
+
+        /*
+         * Starting the search based on the o time, coz may be the more suitable bucket starts at the past
+         * for example if we are in the time 3 we may find the bucket 150 -1 that is the first bucket that matches the lower_bound propierty, but we could used the bucket 0..120
+         */
+        assert(time >= 0);
+        const NodeTimeline& nodeTimeline = this->getTimeline(id);
+        const vector<TimelineSegment>& segments = nodeTimeline.getSegments();
+        size_t pos = nodeTimeline.findSegment(time);
+
+        //initialize the minimum with the resources available in the first segment.
+        TimelineSegment minimum = segments[pos];
+        double timeNextRelease = -1;
+
+        double accuTime = segments[pos].endTime - time;
+        pos++;
+
+        while (accuTime < runtime and pos < segments.size()) {
+            const TimelineSegment& freeSegment = segments[pos];
+            minimum.restrictTo(freeSegment); // the common minimum of the free resources.
+
+            //If by freeSegment any job has been released and it has more resources,
+            //mark it as next possible time to start looking if with current starting point it is not enough
+            if (freeSegment.hasMoreResources(minimum))
+                timeNextRelease = freeSegment.startTime;
+
+            //we move accumulated time forward.
+            accuTime += freeSegment.endTime - freeSegment.startTime;
+            pos++;
+        }
+
+        if (timeNextRelease == -1 and pos < segments.size()) //if no release of resourecs was found, use start of next segment to move on
+            timeNextRelease = segments[pos].startTime;
+
+        //No need to check. If we hit the last segment, then accuTime will be always greater.
+
+        AvailabilityWindow window = {
+            .id = id,
+            .node = this->nodes[id],
+            .startTime = time,
+            .endTime = time + runtime,
+            .freeCPUs = minimum.freeCPUs,
+            .freeMemory = minimum.freeMemory,
+            .freeDisk = minimum.freeDisk,
+            .freeMemoryBW = minimum.freeMemoryBW,
+            .freeDiskBW = minimum.freeDiskBW,
+            .freeFabricBW = minimum.freeFabricBW,
+            .timeNextRelease = timeNextRelease
+        };
+        return window;
+    }
+
+    /**
+     * Same as findFirstWindow, but the nodes of a pool have the same window, so it is computed once per pool and
+     * kept in windows, that has to be empty when the search begins.
+     *
+     * @param time The start time from when the job has to start to explore
+     * @param runtime The minimum length required for the window
+     * @param id The id in the store of the node where the window has to be found
+     * @param windows The windows already found in this search, by pool
+     * @return The window that matches the criteria, its id is the id of the node in the store
+     */
+    AvailabilityWindow TimelineStore::findFirstWindow(double time, double runtime, uint32_t id, vector<AvailabilityWindow>& windows) const {
+        if (windows.empty()) {
+            AvailabilityWindow unknown = {0};
+            unknown.startTime = -1;
+            windows.assign(this->timeline.size(), unknown);
+        }
+
+        //the nodes changed in the overlay do not share the timeline of their pool anymore
+        if (this->overlay and this->overlayTimelines.count(id))
+            return this->findFirstWindow(time, runtime, id);
+
+        uint32_t pool = this->nodePool[id];
+        if (windows[pool].startTime == -1)
+            windows[pool] = this->findFirstWindow(time, runtime, id);
+
+        AvailabilityWindow window = windows[pool];
+        window.id = id;
+        window.node = this->nodes[id];
+        return window;
+    }
+
+    /**
+     * Returns the earliest time, not before the given one, when the nodes of a view together have the given resources
+     * during length, according to the capacity profile of the view.
+     * @param view The view
+     * @param time The time from when the resources are looked for
+     * @param length The time that the resources are needed
+     * @param cpus The cpus needed
+     * @param memory The memory needed
+     * @return The earliest start time, or -1 if the view never has enough resources
+     */
+    double TimelineStore::findEarliestStart(uint32_t view, double time, double length, uint32_t cpus, uint64_t memory) {
+        return this->views[view].capacity.findEarliestStart(time, length, cpus, memory);
+    }
+
+    /**
+     * Removes the past from the store. The capacity profiles and the free node index are trimmed up to now,
+     * the timelines are trimmed a few at a time in round robin, so the cost is spread along the simulation and the number
+     * of segments depends on the reservations in the future and not on the length of the simulated history.
+     * Every view asks for it when its global time changes, the store is only trimmed the first time for every time.
+     * Nothing is trimmed while the overlay is open.
+     * @param now The global time
+     */
+    void TimelineStore::collectGarbage(double now) {
+        if (now <= this->lastTrimTime or this->overlay)
+            return;
+        this->lastTrimTime = now;
+
+        for (vector<TimelineView>::iterator it = this->views.begin(); it != this->views.end(); ++it)
+            it->capacity.trim(now);
+        this->freeNodeIndex.trim(now);
+
+        for (uint32_t i = 0; i < TIMELINES_TRIMMED_PER_STEP and i < this->timeline.size(); i++) {
+            if (this->nextTrimmedPool >= this->timeline.size())
+                this->nextTrimmedPool = 0;
+            uint32_t pool = this->nextTrimmedPool++;
+            if (this->poolSize[pool] == 0 or this->timeline[pool].getSegments().front().startTime >= now)
+                continue;
+
+            //the hash of the pool changes, but it does not merge with others, the nodes do it when they change
+            if (this->nodePools)
+                this->unindexPool(pool);
+            this->timeline[pool].trim(now);
+            if (this->nodePools) {
+                this->poolHash[pool] = this->timeline[pool].getHash();
+                this->poolIndex.insert(std::pair<size_t, uint32_t>(this->poolHash[pool], pool));
+            }
+        }
+    }
+
+    /**
+     * Opens the overlay, the next reservations and releases are done in copies of the timelines until it is committed
+     * or discarded. The capacity profiles and the free node index are updated as usual, the searches see the overlay.
+     */
+    void TimelineStore::beginOverlay() {
+        assert(not this->overlay);
+        this->overlay = true;
+    }
+
+    /**
+     * Closes the overlay keeping its changes. Only the timelines that end up different from the ones in the store are
+     * replaced, so reserving again what was released in the overlay does not change the store at all.
+     */
+    void TimelineStore::commitOverlay() {
+        assert(this->overlay);
+        this->overlay = false;
+
+        for (map<uint32_t, NodeTimeline>::iterator it = this->overlayTimelines.begin(); it != this->overlayTimelines.end(); ++it) {
+            if (it->second.sameSegments(this->timeline[this->nodePool[it->first]]))
+                continue;
+            uint32_t pool = this->detachNode(it->first);
+            this->timeline[pool] = it->second;
+            this->attachNode(it->first);
+            this->changeVersion(it->first);
+        }
+        LOG_DEBUG(log, "Overlay committed, " + to_string(this->overlayChanges.size()) + " changes in " + to_string(this->overlayTimelines.size()) + " nodes", 4);
+        this->overlayTimelines.clear();
+        this->overlayChanges.clear();
+    }
+
+    /**
+     * Closes the overlay dropping its changes. The timelines were not touched, the capacity profiles undo the changes
+     * and the free node index is updated again from the timelines of the nodes that were changed.
+     */
+    void TimelineStore::discardOverlay() {
+        assert(this->overlay);
+        this->overlay = false;
+
+        for (vector<OverlayChange>::reverse_iterator it = this->overlayChanges.rbegin(); it != this->overlayChanges.rend(); ++it)
+            this->changeCapacity(it->node, it->startTime, it->endTime, it->cpus, it->memory, not it->reserve);
+        if (this->reserveFullNode) {
+            for (map<uint32_t, NodeTimeline>::iterator it = this->overlayTimelines.begin(); it != this->overlayTimelines.end(); ++it) {
+                const NodeTimeline& nodeTimeline = this->getTimeline(it->first);
+                const vector<TimelineSegment>& segments = nodeTimeline.getSegments();
+                this->freeNodeIndex.update(it->first, segments.front().startTime, segments.back().startTime, nodeTimeline, this->nodes[it->first]->getNumberCPUs());
+            }
+        }
+        LOG_DEBUG(log, "Overlay discarded, " + to_string(this->overlayChanges.size()) + " changes in " + to_string(this->overlayTimelines.size()) + " nodes", 4);
+        this->overlayTimelines.clear();
+        this->overlayChanges.clear();
+    }
+
+    /**
+     * Returns if the overlay is open
+     * @return True if the changes go to the overlay
+     */
+    bool TimelineStore::hasOverlay() const {
+        return this->overlay;
+    }
+
+    /**
+     * Returns the copy of the timeline of a node in the overlay, it is made the first time that the node is changed
+     * @param id The node
+     * @return A reference to the copy of the timeline
+     */
+    NodeTimeline& TimelineStore::getOverlayTimeline(uint32_t id) {
+        map<uint32_t, NodeTimeline>::iterator it = this->overlayTimelines.find(id);
+        if (it == this->overlayTimelines.end())
+            it = this->overlayTimelines.insert(std::pair<uint32_t, NodeTimeline>(id, this->timeline[this->nodePool[id]])).first;
+        return it->second;
+    }
+
+    /**
+     * Gives a node a pool of its own, so its timeline can be changed without changing the other nodes.
+     * The pool is taken out of the index, attachNode has to be called once the timeline has been changed.
+     * @param id The node
+     * @return The pool of the node
+     */
+    uint32_t TimelineStore::detachNode(uint32_t id) {
+        uint32_t pool = this->nodePool[id];
+        if (this->poolSize[pool] == 1) {
+            if (this->nodePools)
+                this->unindexPool(pool);
+            return pool;
+        }
+
+        this->poolSize[pool]--;
+        NodeTimeline copy = this->timeline[pool];
+        pool = this->newPool(copy);
+        this->nodePool[id] = pool;
+        return pool;
+    }
+
+    /**
+     * Moves a detached node to the pool with the same timeline, if there is any, or indexes its own pool otherwise.
+     * @param id The node
+     */
+    void TimelineStore::attachNode(uint32_t id) {
+        if (not this->nodePools)
+            return;
+
+        uint32_t pool = this->nodePool[id];
+        assert(this->poolSize[pool] == 1);
+        size_t hash = this->timeline[pool].getHash();
+
+        pair<multimap<size_t, uint32_t>::iterator, multimap<size_t, uint32_t>::iterator> range = this->poolIndex.equal_range(hash);
+        for (multimap<size_t, uint32_t>::iterator it = range.first; it != range.second; ++it) {
+            if (this->timeline[it->second].sameSegments(this->timeline[pool])) {
+                this->nodePool[id] = it->second;
+                this->poolSize[it->second]++;
+                this->poolSize[pool] = 0;
+                this->unusedPools.push_back(pool);
+                return;
+            }
+        }
+
+        this->poolHash[pool] = hash;
+        this->poolIndex.insert(std::pair<size_t, uint32_t>(hash, pool));
+    }
+
+    /**
+     * Creates a pool without nodes, reusing an unused one when possible
+     * @param poolTimeline The timeline of the pool
+     * @return The pool
+     */
+    uint32_t TimelineStore::newPool(const NodeTimeline& poolTimeline) {
+        if (not this->unusedPools.empty()) {
+            uint32_t pool = this->unusedPools.back();
+            this->unusedPools.pop_back();
+            this->timeline[pool] = poolTimeline;
+            this->poolSize[pool] = 1;
+            return pool;
+        }
+
+        this->timeline.push_back(poolTimeline);
+        this->poolSize.push_back(1);
+        this->poolHash.push_back(0);
+        return this->timeline.size() - 1;
+    }
+
+    /**
+     * Removes a pool from the index, before its timeline changes
+     * @param pool The pool
+     */
+    void TimelineStore::unindexPool(uint32_t pool) {
+        pair<multimap<size_t, uint32_t>::iterator, multimap<size_t, uint32_t>::iterator> range = this->poolIndex.equal_range(this->poolHash[pool]);
+        for (multimap<size_t, uint32_t>::iterator it = range.first; it != range.second; ++it) {
+            if (it->second == pool) {
+                this->poolIndex.erase(it);
+                return;
+            }
+        }
+        assert(false);
+    }
+
+}
@@ -0,0 +1,152 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATORTIMELINESTORE_H
+#define SIMULATORTIMELINESTORE_H
+
+#include <scheduling/nodetimeline.h>
+#include <scheduling/capacityprofile.h>
+#include <scheduling/freenodeindex.h>
+
+#include <map>
+#include <vector>
+
+using std::map;
+using std::multimap;
+using std::vector;
+
+/** The number of timelines whose past is trimmed every time the global time changes */
+#define TIMELINES_TRIMMED_PER_STEP 64
+
+namespace Utils {
+    class Log;
+}
+
+namespace ArchDataModel {
+    class Node;
+}
+
+namespace Simulator {
+
+    /**
+     * A range of nodes of the store seen as a reservation table of its own, with the free resources of its nodes
+     * together along the time.
+     */
+    struct TimelineView {
+        uint32_t firstNode; /**< The id in the store of the first node of the view */
+        uint32_t numberOfNodes; /**< The number of nodes of the view, their ids in the store are consecutive */
+        CapacityProfile capacity; /**< The free resources of all the nodes of the view together along the time */
+        uint64_t version; /**< The number of times that the timelines of the nodes of the view have changed */
+
+        TimelineView(double startTime) : firstNode(0), numberOfNodes(0), capacity(startTime), version(0) {
+        }
+    };
+
+    /** A reservation or a release done in the overlay of the store, kept to undo it in the capacity profiles. */
+    struct OverlayChange {
+        uint32_t node; /**< The id in the store of the node */
+        double startTime; /**< The first time of the change */
+        double endTime; /**< The last time of the change */
+        uint32_t cpus; /**< The cpus reserved or released */
+        uint64_t memory; /**< The memory reserved or released */
+        bool reserve; /**< True for a reservation, false for a release */
+    };
+
+    /**
+     * The timelines of all the nodes of the system, shared by the reservation tables of the system orchestrator and of the
+     * partitions. Each reservation table is a view, a range of nodes of the store, so every node has a single timeline
+     * whatever the number of tables that contain it. The store also keeps the indexes of the timelines: the node pools, the
+     * capacity profile of every view and the free node index.
+     * The store can open an overlay where the changes are tried without touching the timelines: the first change of a node
+     * copies its timeline, the next ones and the searches use the copy. Committing the overlay replaces the timelines that
+     * have actually changed, discarding it leaves them as they were.
+     */
+    class TimelineStore {
+    public:
+        TimelineStore(double startTime, Utils::Log* log);
+        ~TimelineStore();
+
+        uint32_t addView(double startTime);
+        uint32_t addNode(uint32_t view, ArchDataModel::Node* node, double startTime);
+        uint32_t getFirstNode(uint32_t view) const;
+        uint32_t getNumberOfNodes(uint32_t view) const;
+        uint64_t getVersion(uint32_t view) const;
+        ArchDataModel::Node* getNode(uint32_t id) const;
+        const NodeTimeline& getTimeline(uint32_t id) const;
+
+        void setNodePools(bool nodePools);
+        bool getNodePools() const;
+        uint32_t getNumberOfPools() const;
+        void setReserveFullNode(bool reserveFullNode);
+        bool getReserveFullNode() const;
+        void setEarliestStartSearch(bool earliestStartSearch);
+        bool getEarliestStartSearch() const;
+        const FreeNodeIndex& getFreeNodeIndex() const;
+
+        void reserve(uint32_t id, double startTime, double endTime, const ReservationList& rl);
+        void release(uint32_t id, double startTime, double endTime, const ReservationList& rl);
+        AvailabilityWindow findFirstWindow(double time, double runtime, uint32_t id) const;
+        AvailabilityWindow findFirstWindow(double time, double runtime, uint32_t id, vector<AvailabilityWindow>& windows) const;
+        double findEarliestStart(uint32_t view, double time, double length, uint32_t cpus, uint64_t memory);
+        void collectGarbage(double now);
+
+        void beginOverlay();
+        void commitOverlay();
+        void discardOverlay();
+        bool hasOverlay() const;
+
+    private:
+        uint32_t detachNode(uint32_t id);
+        void attachNode(uint32_t id);
+        uint32_t newPool(const NodeTimeline& poolTimeline);
+        void unindexPool(uint32_t pool);
+        NodeTimeline& getOverlayTimeline(uint32_t id);
+        void changeCapacity(uint32_t id, double startTime, double endTime, uint32_t cpus, uint64_t memory, bool reserve);
+        void changeVersion(uint32_t id);
+
+        Utils::Log* log; /**< The logging engine */
+        double startTime; /**< The time when the store was created, the timelines begin at it */
+        vector<TimelineView> views; /**< The views over the store, one per reservation table */
+        vector<ArchDataModel::Node*> nodes; /**< The nodes of the store, the position of a node is its id in the store */
+        map<ArchDataModel::Node*, uint32_t> nodeIds; /**< The id of every node, a node is added once by every view that contains it */
+
+        vector<NodeTimeline> timeline; /**< A NodeTimeline per pool of nodes, the nodes of a pool are in the same state. */
+        vector<uint32_t> nodePool; /**< the pool of every node, that is the position of its NodeTimeline */
+        vector<uint32_t> poolSize; /**< the number of nodes in every pool, 0 for the unused ones */
+        vector<size_t> poolHash; /**< the hash of the timeline of every pool when it was indexed */
+        vector<uint32_t> unusedPools; /**< the pools that can be reused */
+        multimap<size_t, uint32_t> poolIndex; /**< the pools by the hash of their timeline, used to find the pool that a node can join */
+        bool nodePools; /**< if true the nodes with the same timeline share a single pool, otherwise every node has its own */
+
+        FreeNodeIndex freeNodeIndex; /**< the nodes that are completely free along the time, only kept when reserveFullNode is set */
+        bool reserveFullNode; /**< if true the jobs only reserve full nodes */
+        bool earliestStartSearch; /**< if true findEarliestStart is answered with the capacity profiles, otherwise the searches explore every time */
+
+        uint32_t nextTrimmedPool; /**< the next pool whose timeline has to be trimmed */
+        double lastTrimTime; /**< the last time up to which the store has been trimmed */
+
+        bool overlay; /**< true while the changes go to the overlay instead of the timelines */
+        map<uint32_t, NodeTimeline> overlayTimelines; /**< the copies of the timelines changed in the overlay, by node */
+        vector<OverlayChange> overlayChanges; /**< the changes done in the overlay, in order */
+    };
+
+}
+
+#endif
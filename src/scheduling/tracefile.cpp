@@ -236,5 +236,28 @@ void TraceFile::setLoadedJobs ( double theValue )
 	LoadedJobs = theValue;
 }
 
+/**
+ * Builds the dependency graph of the workload: every job gets its preceeding jobs resolved, its succeeding jobs and
+ * the number of preceeding jobs that it has to wait for. A preceeding job that is not in the workload never finishes.
+ */
+void TraceFile::buildDependencies()
+{
+	for(map<int,Job*>::iterator it = JobList.begin(); it != JobList.end(); ++it)
+	{
+		Job* job = it->second;
+		vector<int> preceeding = job->getPreceedingJobs();
+		job->setUnmetPredecessors(preceeding.size());
+
+		for(vector<int>::iterator pj = preceeding.begin(); pj != preceeding.end(); ++pj)
+		{
+			map<int,Job*>::iterator found = JobList.find(*pj);
+			if(found != JobList.end())
+				job->addPredecessor(found->second);
+			else
+				log->debug("The preceeding job " + to_string(*pj) + " of the job " + to_string(job->getJobNumber()) + " is not in the workload", 1);
+		}
+	}
+}
+
 
 }
@@ -48,7 +48,7 @@ public:
   //Constructors and desctructors
   TraceFile();  
   TraceFile(string FilePath,Log* log);	
-  ~TraceFile();
+  virtual ~TraceFile();
   
   //Sets and gets method
   void setFilePath(string& theValue);	
@@ -72,6 +72,7 @@ public:
   double getLoadTillJob() const;
   void setLoadedJobs ( double theValue );
   double getLoadedJobs() const;
+  void buildDependencies();
 	
 	
 	  
@@ -22,9 +22,7 @@
 #define STATISTICSPROCESS_H
 
 
-#define MODLUS 2147483647
-#define MULT1 24112
-#define MULT2 26143
+#include <statistics/randomstream.h>
 
 #ifndef UDTIME
 #define UDTIME double
@@ -38,15 +36,9 @@ namespace Statistics {
 class Process{
 // A partir d'aquesta classe, hom pot derivar qualsevol tasca o objecte que necessiti d'una determinada distribuci�. Tan sols
 // haur� de programar la constructora de la seva classe i la funci� DeltaProx().
-  //lastnumber permet independitzar l'array de nombres aleatoris de cada un dels processos de generaci� de n�meros aleatoris.
-  //@cmember Keeps the last random number generated. 
-  long lastNumber;
-  //@cmember Generates a random number by Law & Kelton method.
-  double rando2(long stream);
 protected: 
-  //@cmember Array of seeds for generate random numbers.
-	static int lastStream;
-	static long zrng[101];
+  //@cmember The stream of the random numbers, every process has its own.
+	RandomStream random;
 
 	double epsilon;
 public:
@@ -58,12 +50,12 @@ public:
 			POISSON_DISTRIBUTION,
     };
 
-  //@cmember Returns the last random number generated.
-  long GetLastNumber();
-  //@cmember Keeps the last random number generated.
-  int SetLastNumber(long lastNumber);
-  //@cmember  Generates a random number by Law & Kelton method.
-  double rando(long stream=0);
+  //@cmember Uses the stream number stream of the default seed.
+  void SetStream(int stream);
+  //@cmember Uses a given stream, for instance one split from the stream of a replica.
+  void SetRandomStream(const RandomStream& stream);
+  //@cmember Generates a random number in ]0,1[.
+  double rando();
   //@cmember Returns a random number. This function will be overriden by derived classes.
   //ConvertToTime Indica si cal convertir el valor a format temporal
   virtual UDTIME DeltaProx();
@@ -35,14 +35,13 @@ ProcessErlang::ProcessErlang(double beta0,int m0)
 {
 	beta=beta0;
 	m=m0;
-	SetLastNumber(zrng[lastStream]);
 }
 
 ProcessErlang::ProcessErlang(double beta0,int m0, int stream)
 {
   beta=beta0;
   m=m0;
-  SetLastNumber(zrng[stream]);
+  SetStream(stream);
 }
 
 //@mfunc Returns the number of stages.
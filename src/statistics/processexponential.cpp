@@ -34,14 +34,13 @@ ProcessExponential::ProcessExponential(double mu0,  int stream)
 {
   mu = mu0;
   // per a evitar zeros en el long de DeltaProx()
-  SetLastNumber(zrng[stream]);
+  SetStream(stream);
 }
 
 ProcessExponential::ProcessExponential(double mu0)
 {
   mu = mu0;
   // per a evitar zeros en el long de DeltaProx()
-  SetLastNumber(zrng[lastStream]);
 }
 
 //@mfunc Returns the time beetwen arrivals.
@@ -34,7 +34,7 @@ namespace Statistics {
 ProcessGeometric::ProcessGeometric (double p0,  int stream)       
 {
   p=log(1-p0);  
-  SetLastNumber(zrng[stream]);
+  SetStream(stream);
 }
 
 ProcessGeometric::ProcessGeometric (double p0)       
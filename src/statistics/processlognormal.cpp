@@ -35,14 +35,13 @@ ProcessLogNormal::ProcessLogNormal(double mu0,double sigma0,  int stream) :
 	   ProcessNormal(mu0, sigma0)
 {
   //La mu i la sigma son heredades de la classe pare.
-  SetLastNumber(zrng[stream]);
+  SetStream(stream);
 }
 
 ProcessLogNormal::ProcessLogNormal(double mu0,double sigma0) :
 	   ProcessNormal(mu0, sigma0)
 {
   //La mu i la sigma son heredades de la classe pare.
-  SetLastNumber(zrng[lastStream]);
 }
 
 //@mfunc Returns a lognormal random number.
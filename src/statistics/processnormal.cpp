@@ -37,7 +37,7 @@ ProcessNormal::ProcessNormal(double mu0,double sigma0,  int stream)
   sigma=sigma0; */
 	SetMu(mu0);
 	SetSigma(sigma0);
-	SetLastNumber(zrng[stream]);
+	SetStream(stream);
 }
 
 ProcessNormal::ProcessNormal(double mu0,double sigma0)
@@ -46,7 +46,6 @@ ProcessNormal::ProcessNormal(double mu0,double sigma0)
   sigma=sigma0; */
 	SetMu(mu0);
 	SetSigma(sigma0);
-    SetLastNumber(zrng[lastStream]);
 }
 
 //@mfunc Returns distribution's average.
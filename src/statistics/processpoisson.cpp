@@ -34,14 +34,13 @@ ProcessPoisson::ProcessPoisson(double lambda0,  int stream)
 {
   lambda = lambda0;
   // per a evitar zeros en el log de DeltaProx()
-  SetLastNumber(zrng[stream]);
+  SetStream(stream);
 }
 
 ProcessPoisson::ProcessPoisson(double lambda0)
 {
   lambda = lambda0;
   // per a evitar zeros en el log de DeltaProx()
-  SetLastNumber(zrng[lastStream]);
 }
 
 //@mfunc Returns the frequency of enities arrivals.
@@ -38,7 +38,7 @@ ProcessTriangular::ProcessTriangular(double a0, double b0, double c0, int stream
  a=a0;
  b=b0;
  c=c0;
- SetLastNumber(zrng[stream]);
+ SetStream(stream);
 }
 ProcessTriangular::ProcessTriangular(double a0, double b0, double c0)
 {
@@ -35,7 +35,6 @@ ProcessUniform::ProcessUniform(double a0, double b0)
 {
   a = a0;
   b = b0;
-  SetLastNumber(zrng[Process::lastStream]);
 }
  
 
@@ -47,7 +46,7 @@ ProcessUniform::ProcessUniform(double a0, double b0,  int stream)
 {
   a = a0;
   b = b0;
-  SetLastNumber(zrng[stream]);
+  SetStream(stream);
 }
 
 //@mfunc Returns the lower edge.
@@ -36,13 +36,12 @@ ProcessWeibull::ProcessWeibull (double alfa0,double beta0,  int stream)
 {
   alfa=alfa0;
   beta=beta0;
-  SetLastNumber(zrng[stream]);
+  SetStream(stream);
 }
 ProcessWeibull::ProcessWeibull (double alfa0,double beta0)
 {
   alfa=alfa0;
   beta=beta0;
-  SetLastNumber(zrng[lastStream]);
 }
 
 //@mfunc Returns alfa Weibull parameter.
@@ -0,0 +1,107 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <statistics/randomstream.h>
+
+namespace Statistics {
+
+//@mfunc Rotates a 64 bits word to the left.
+static inline uint64_t rotl(const uint64_t x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+//@mfunc Creates the stream number stream of a seed. The state is filled from the seed by splitmix64 and then jumps
+//2^128 numbers ahead for every stream, so the streams of a seed do not overlap.
+//@parm uint64_t | seed | The seed of the streams.
+//@parm uint64_t | stream | The number of the stream.
+RandomStream::RandomStream(uint64_t seed, uint64_t stream)
+{
+  uint64_t x = seed;
+  for(int i = 0; i < 4; i++)
+  {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    s[i] = z ^ (z >> 31);
+  }
+  for(uint64_t i = 0; i < stream; i++)
+    jump();
+}
+
+//@mfunc Returns the next 64 random bits.
+//@rdesc Returns the next 64 random bits.
+uint64_t RandomStream::next()
+{
+  const uint64_t result = rotl(s[1] * 5, 7) * 9;
+  const uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+
+  return result;
+}
+
+//@mfunc Returns a random number in ]0,1[, from the upper 53 bits.
+//@rdesc Returns a random number in ]0,1[.
+double RandomStream::nextDouble()
+{
+  return ((next() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+//@mfunc Jumps 2^128 numbers ahead, it is the same as calling next() 2^128 times.
+void RandomStream::jump()
+{
+  static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+  uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  for(int i = 0; i < 4; i++)
+    for(int b = 0; b < 64; b++)
+    {
+      if (JUMP[i] & (1ULL << b))
+      {
+        s0 ^= s[0];
+        s1 ^= s[1];
+        s2 ^= s[2];
+        s3 ^= s[3];
+      }
+      next();
+    }
+  s[0] = s0;
+  s[1] = s1;
+  s[2] = s2;
+  s[3] = s3;
+}
+
+//@mfunc Returns a new stream that starts where this one is and moves this one 2^128 numbers ahead, the returned
+//stream can use them without overlapping the numbers that this one will give.
+//@rdesc Returns the new stream.
+RandomStream RandomStream::split()
+{
+  RandomStream child = *this;
+  jump();
+  return child;
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef STATISTICSRANDOMSTREAM_H
+#define STATISTICSRANDOMSTREAM_H
+
+#include <stdint.h>
+
+#define DEFAULT_RANDOM_SEED 1973272912
+
+namespace Statistics {
+
+//@class A stream of random numbers with its own state, a xoshiro256** generator. A stream can be split in independent
+//streams that do not overlap, every split jumps 2^128 numbers ahead, so concurrent simulations and the processes inside
+//a simulation do not share any state and the numbers that they get do not depend on the order in which they run.
+class RandomStream{
+  //@cmember The state of the generator.
+  uint64_t s[4];
+  //@cmember Jumps 2^128 numbers ahead.
+  void jump();
+public:
+  //@cmember Creates the stream number stream of a seed.
+  RandomStream(uint64_t seed=DEFAULT_RANDOM_SEED, uint64_t stream=0);
+  //@cmember Returns the next 64 random bits.
+  uint64_t next();
+  //@cmember Returns a random number in ]0,1[.
+  double nextDouble();
+  //@cmember Returns a new stream that starts where this one is and moves this one to the next independent stream.
+  RandomStream split();
+};
+
+}
+
+#endif
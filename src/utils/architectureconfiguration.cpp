@@ -37,11 +37,21 @@ ArchitectureConfiguration::ArchitectureConfiguration(std::string configFile, Uti
 	this->totalMemory = 0;
 	this->architectureType = type;
 	this->startime		= startime;
+	this->sysorch			= NULL;
 }
 
-ArchitectureConfiguration::ArchitectureConfiguration() {}
+ArchitectureConfiguration::ArchitectureConfiguration() {
+	this->sysorch = NULL;
+}
 
-ArchitectureConfiguration::~ArchitectureConfiguration() {}
+/**
+ * Frees the system orchestrator, with its partitions and policies, before the nodes that its reservation tables use.
+ */
+ArchitectureConfiguration::~ArchitectureConfiguration() {
+	delete sysorch;
+	for(uint32_t i = 0; i < partitionLists.size(); i++)
+		delete partitionLists[i];
+}
 
 bool ArchitectureConfiguration::loadConfigurationFromFile() {
 	//TODO
@@ -148,6 +158,9 @@ bool ArchitectureConfiguration::readSystemArchitecture(boost::property_tree::ptr
 	catch(std::exception const& e) {
 		log->error("Exception caught: " + std::string(e.what()) + ".");
 	}
+	//the nodes have clones of the resources
+	for(std::map<std::string, Resource*>::iterator it = resources.begin(); it != resources.end(); ++it)
+		delete it->second;
 	
 	totalCPUs = 0;
 	totalMemory = 0;
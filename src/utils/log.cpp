@@ -24,10 +24,17 @@
 #include <utils/utilities.h>
 #include <string>
 #include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 namespace Utils {
 
+    Log* Log::crashLog = NULL;
+
     /***************************
       Constructor and destructors
      ***************************/
@@ -58,6 +65,7 @@ namespace Utils {
      * The default destructor for the class 
      */
     Log::~Log() {
+        this->flush();
         this->ErrorFile.close();
         this->DebugFile.close();
     }
@@ -90,6 +98,7 @@ namespace Utils {
         char * time = ctime(&rawtime);
         time[24] = ' '; //chomp te \n character  
 
+        std::lock_guard<std::mutex> lock(this->outputMutex);
         this->ErrorFile << "[" << time << "] " << error << endl;
 
         if (this->showErrors || this->verboseMode)
@@ -99,7 +108,8 @@ namespace Utils {
     }
 
     /**
-     * Debugs a message with a given level. If the levelmsg is lower than the level set the message will be stored 
+     * Debugs a message with a given level. If the levelmsg is lower than the level set the message will be stored. It can be
+     * called from several threads, the messages are written one after the other.
      * @param log The debug message 
      * @param levelmsg The level of the message 
      */
@@ -107,8 +117,9 @@ namespace Utils {
 
 
 
-        if (this->debugEnabled && this->level >= levelmsg) {
+        if (this->isDebugEnabled(levelmsg)) {
             string time = to_string(*gt);
+            std::lock_guard<std::mutex> lock(this->outputMutex);
 
             if (this->verboseMode) {
                 //Ok, if we are in verbose mode we don't dump the stuff to the LogFile
@@ -118,6 +129,8 @@ namespace Utils {
             if (this->bufferToMemory) {
                 this->debugBuf << "[" << time << " (L" + to_string(levelmsg) + ")] " << log << endl;
 
+            } else if (!this->ringBuffer.empty() || this->writerRunning) {
+                this->writeDebugLine("[" + time + " (L" + to_string(levelmsg) + ")] " + log + "\n");
             } else {
                 this->DebugFile << "[" << time << " (L" + to_string(levelmsg) + ")] " << log << endl;
             }
@@ -245,4 +258,168 @@ namespace Utils {
 
     }
 
-}
\ No newline at end of file
+    /**
+     * Keeps only the last bytes of the debug output in memory instead of writing it to the debug file. The buffer is written
+     * to the debug file when the log is flushed or when the simulation crashes (see installCrashHandlers).
+     * @param bytes The size of the ring buffer, 0 writes the debug output to the file as usual
+     */
+    void Log::setRingBufferSize(size_t bytes) {
+        assert(!this->writerRunning);
+        this->ringBuffer.assign(bytes, 0);
+        this->ringPosition = 0;
+        this->ringWrapped = false;
+    }
+
+    /**
+     * Starts a thread that writes the debug output to the debug file in blocks of LOG_WRITER_BLOCK_SIZE, so the simulation
+     * does not wait for the file on every message. It is not used together with the ring buffer.
+     */
+    void Log::startWriterThread() {
+        if (this->writerRunning || !this->ringBuffer.empty() || this->bufferToMemory)
+            return;
+        this->writerStop = false;
+        this->currentBlock.reserve(LOG_WRITER_BLOCK_SIZE);
+        this->writerRunning = true;
+        this->writerThread = std::thread(&Log::writerLoop, this);
+    }
+
+    /**
+     * Writes all the pending debug output: the content of the ring buffer or the blocks of the background writer, that is stopped.
+     */
+    void Log::flush() {
+        std::lock_guard<std::mutex> lock(this->outputMutex);
+        if (this->writerRunning) {
+            {
+                std::unique_lock<std::mutex> lock(this->writerMutex);
+                this->readyBlocks.push_back(this->currentBlock);
+                this->currentBlock.clear();
+                this->writerStop = true;
+            }
+            this->writerWakeUp.notify_one();
+            this->writerThread.join();
+            this->writerRunning = false;
+        }
+        if (!this->ringBuffer.empty() && this->DebugFile.is_open()) {
+            if (this->ringWrapped)
+                this->DebugFile.write(&this->ringBuffer[this->ringPosition], this->ringBuffer.size() - this->ringPosition);
+            this->DebugFile.write(&this->ringBuffer[0], this->ringPosition);
+            this->ringPosition = 0;
+            this->ringWrapped = false;
+        }
+        this->DebugFile.flush();
+    }
+
+    /**
+     * Appends the content of the ring buffer to the debug file. It only uses system calls so it can be called from a signal handler.
+     */
+    void Log::dumpRingBuffer() {
+        if (this->ringBuffer.empty() || this->DebugPath == "")
+            return;
+        int fd = open(this->DebugPath.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (fd < 0)
+            return;
+        if (this->ringWrapped && write(fd, &this->ringBuffer[this->ringPosition], this->ringBuffer.size() - this->ringPosition) < 0) {
+            close(fd);
+            return;
+        }
+        if (write(fd, &this->ringBuffer[0], this->ringPosition) >= 0) {
+            this->ringPosition = 0;
+            this->ringWrapped = false;
+        }
+        close(fd);
+    }
+
+    /**
+     * Installs the handlers that dump the ring buffer of the log when the simulation aborts (a failed assert) or receives a SIGTERM.
+     * @param log The log whose ring buffer is dumped
+     */
+    void Log::installCrashHandlers(Log* log) {
+        Log::crashLog = log;
+        signal(SIGABRT, Log::crashHandler);
+        signal(SIGTERM, Log::crashHandler);
+    }
+
+    /**
+     * Dumps the ring buffer and lets the signal terminate the simulation.
+     * @param signum The signal received
+     */
+    void Log::crashHandler(int signum) {
+        if (Log::crashLog != NULL)
+            Log::crashLog->dumpRingBuffer();
+        signal(signum, SIG_DFL);
+        raise(signum);
+    }
+
+    /**
+     * Stores a debug line in the ring buffer or hands it to the background writer
+     * @param line The formatted debug line
+     */
+    void Log::writeDebugLine(const string& line) {
+        if (!this->ringBuffer.empty()) {
+            this->appendToRingBuffer(line);
+            return;
+        }
+        this->currentBlock += line;
+        if (this->currentBlock.size() < LOG_WRITER_BLOCK_SIZE)
+            return;
+        {
+            std::unique_lock<std::mutex> lock(this->writerMutex);
+            //the simulation only waits if the writer can not keep up, so memory stays bounded
+            while (this->readyBlocks.size() >= LOG_WRITER_MAX_BLOCKS)
+                this->writerDone.wait(lock);
+            this->readyBlocks.push_back(string());
+            this->readyBlocks.back().swap(this->currentBlock);
+        }
+        this->currentBlock.reserve(LOG_WRITER_BLOCK_SIZE);
+        this->writerWakeUp.notify_one();
+    }
+
+    /**
+     * Copies a debug line in the ring buffer, overwriting the oldest output if it is full
+     * @param line The formatted debug line
+     */
+    void Log::appendToRingBuffer(const string& line) {
+        size_t capacity = this->ringBuffer.size();
+        const char* data = line.data();
+        size_t length = line.size();
+        //only the tail of a line larger than the buffer can be kept
+        if (length > capacity) {
+            data += length - capacity;
+            length = capacity;
+        }
+        while (length > 0) {
+            size_t chunk = min(length, capacity - this->ringPosition);
+            memcpy(&this->ringBuffer[this->ringPosition], data, chunk);
+            this->ringPosition += chunk;
+            data += chunk;
+            length -= chunk;
+            if (this->ringPosition == capacity) {
+                this->ringPosition = 0;
+                this->ringWrapped = true;
+            }
+        }
+    }
+
+    /**
+     * Main function of the background writer: writes the ready blocks to the debug file until it is asked to stop.
+     */
+    void Log::writerLoop() {
+        std::unique_lock<std::mutex> lock(this->writerMutex);
+        while (true) {
+            while (this->readyBlocks.empty() && !this->writerStop)
+                this->writerWakeUp.wait(lock);
+            if (this->readyBlocks.empty())
+                break;
+            vector<string> blocks;
+            blocks.swap(this->readyBlocks);
+            this->writerDone.notify_all();
+            //the file is written without holding the lock, the simulation keeps filling the next block
+            lock.unlock();
+            for (vector<string>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+                this->DebugFile.write(it->data(), it->size());
+            lock.lock();
+        }
+        this->DebugFile.flush();
+    }
+
+}
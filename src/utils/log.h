@@ -21,15 +21,50 @@
 #ifndef SIMULATORLOG_H
 #define SIMULATORLOG_H
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <climits>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
 using namespace std;
 
+/*
+ * Debug messages with a level above LOG_MAX_LEVEL are removed at compile time (see --enable-debug-level in configure).
+ * By default all of them are kept and filtered at run time.
+ */
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL INT_MAX
+#endif
+
+/** Amount of debug output that the background writer accumulates before writing it to the debug file */
+#define LOG_WRITER_BLOCK_SIZE (4 * 1024 * 1024)
+/** Number of blocks that may be waiting for the background writer before the simulation has to wait for it */
+#define LOG_WRITER_MAX_BLOCKS 4
+
+/**
+ * Debugs a message only if the level is enabled. Unlike calling Log::debug directly, the message is not built when the level
+ * is disabled, so it can be used in the hot paths of the simulation.
+ * @param log The logging engine
+ * @param msg The expression that builds the debug message
+ * @param levelmsg The level of the message, it must be a constant
+ */
+#define LOG_DEBUG(log, msg, levelmsg) \
+    do { \
+        if ((levelmsg) <= LOG_MAX_LEVEL && (log)->isDebugEnabled(levelmsg)) \
+            (log)->debug(msg, levelmsg); \
+    } while (0)
+
 
 namespace Utils {
 
@@ -49,6 +84,7 @@ namespace Utils {
         void debugConfig(string log);
         void debugDefault(string log);
         void debug(string log, int levelmsg = 1);
+        bool isDebugEnabled(int levelmsg) const;
 
         //set and gets methods
         void setLevel(int& theValue);
@@ -60,6 +96,12 @@ namespace Utils {
         void setglobalTimeref(uint64_t *);
         
         void beginFile(string ErrorPath, string DebugPath);
+
+        void setRingBufferSize(size_t bytes);
+        void startWriterThread();
+        void flush();
+        void dumpRingBuffer();
+        static void installCrashHandlers(Log* log);
         
 
 
@@ -81,8 +123,40 @@ namespace Utils {
         
         std::ostringstream errorBuf;
         std::ostringstream debugBuf;
+        std::mutex outputMutex; /**< Serialises the messages, so the partitions can be scheduled in threads with the debug enabled */
+
+        void writeDebugLine(const string& line);
+        void appendToRingBuffer(const string& line);
+        void writerLoop();
+        static void crashHandler(int signum);
+
+        //bounded in memory buffer, only the last ringCapacity bytes of debug output are kept
+        vector<char> ringBuffer; /**< The ring buffer with the last debug output, empty if the ring buffer is not used */
+        size_t ringPosition = 0; /**< The position of the ring buffer where the next character is written */
+        bool ringWrapped = false; /**< Indicates if the ring buffer has been filled at least once */
+
+        //background writer
+        bool writerRunning = false; /**< Indicates if the debug output is written by the background writer */
+        bool writerStop = false; /**< Asks the background writer to write the pending output and finish */
+        std::thread writerThread; /**< The thread that writes the debug output to the debug file */
+        std::mutex writerMutex; /**< Protects the blocks shared with the background writer */
+        std::condition_variable writerWakeUp; /**< Signals the writer that a block is ready or that it has to finish */
+        std::condition_variable writerDone; /**< Signals the simulation that the writer has written a block */
+        string currentBlock; /**< The block that is being filled by the simulation */
+        vector<string> readyBlocks; /**< The blocks waiting to be written by the background writer */
+
+        static Log* crashLog; /**< The log whose ring buffer is dumped when the simulation crashes */
     };
 
+    /**
+     * Indicates if the messages of a given level are stored. It is inlined because it is checked before building every debug message.
+     * @param levelmsg The level of the message
+     * @return True if the message would be stored
+     */
+    inline bool Log::isDebugEnabled(int levelmsg) const {
+        return this->debugEnabled && this->level >= levelmsg;
+    }
+
 }
 
 #endif
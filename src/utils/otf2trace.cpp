@@ -74,9 +74,9 @@ namespace Utils {
 
     void otf2trace::setLog(Log* log) {
         this->log = log;
-        log->debug("Log set", 1);
-        log->debug("Output filename for otf2 set to " + this->tracename, 1);
-        log->debug("Output directory for otf2 set to " + this->tracedir, 1);
+        LOG_DEBUG(log, "Log set", 1);
+        LOG_DEBUG(log, "Output filename for otf2 set to " + this->tracename, 1);
+        LOG_DEBUG(log, "Output directory for otf2 set to " + this->tracedir, 1);
     }
 
     void otf2trace::jobStart(int job_id, deque<ResourceBucket*>& allocations, bool do_io) {
@@ -85,7 +85,7 @@ namespace Utils {
          * For each node used, generate a region for this job.
          * Pick up the location by indexing the "locations" vector.
          */
-        log->debug("OTF2 jobStart for job:" + to_string(job_id) + ".", 1);
+        LOG_DEBUG(log, "OTF2 jobStart for job:" + to_string(job_id) + ".", 1);
 
 
         /*
@@ -113,7 +113,7 @@ namespace Utils {
                 (*p_ar) << l;
             }
 
-            log->debug("OTF2 Locationally correct: " + to_string(job_id) + ".", 1);
+            LOG_DEBUG(log, "OTF2 Locationally correct: " + to_string(job_id) + ".", 1);
             /*
              * Generate the region for this bucket, and push that to the archive.
              * Note that regioncount is actually a user defined tag that we don't desperately care about, except that it must be unique.
@@ -129,10 +129,10 @@ namespace Utils {
                 
             if (do_io == true) {
                 otf2::definition::region region(regioncount++, strings[10 + job_id], strings[5], strings[6], otf2::definition::region::role_type::file_io, otf2::definition::region::paradigm_type::user, otf2::definition::region::flags_type::none, strings[7], 0, 0);
-                log->debug("OTF2 Region okay " + to_string(job_id) + ".", 1);
+                LOG_DEBUG(log, "OTF2 Region okay " + to_string(job_id) + ".", 1);
                 (*p_ar) << region; // You can push back a region directly to an archive.
 
-                log->debug("OTF2 BUCKET iterator:" + to_string(job_id) + ".", 1);
+                LOG_DEBUG(log, "OTF2 BUCKET iterator:" + to_string(job_id) + ".", 1);
                 /*
                  * Create a struct to hold information about this job region, the job ID, the region handle and the bucket ID.
                  * Then, place this into the array of all job region structs, for later reference.
@@ -142,10 +142,10 @@ namespace Utils {
 
             } else {
                 otf2::definition::region region(regioncount++, strings[10 + job_id], strings[5], strings[6], otf2::definition::region::role_type::function, otf2::definition::region::paradigm_type::user, otf2::definition::region::flags_type::none, strings[7], 0, 0);
-                log->debug("OTF2 Region okay " + to_string(job_id) + ".", 1);
+                LOG_DEBUG(log, "OTF2 Region okay " + to_string(job_id) + ".", 1);
                 (*p_ar) << region; // You can push back a region directly to an archive.
 
-                log->debug("OTF2 BUCKET iterator:" + to_string(job_id) + ".", 1);
+                LOG_DEBUG(log, "OTF2 BUCKET iterator:" + to_string(job_id) + ".", 1);
                 /*
                  * Create a struct to hold information about this job region, the job ID, the region handle and the bucket ID.
                  * Then, place this into the array of all job region structs, for later reference.
@@ -183,7 +183,7 @@ namespace Utils {
 
 
 
-            log->debug("OTF2 JobSta  (" + to_string(job_id) + ") at " + to_string(bucket->getStartTime()) + " on Node " + to_string(jr.nodeid), 6);
+            LOG_DEBUG(log, "OTF2 JobSta  (" + to_string(job_id) + ") at " + to_string(bucket->getStartTime()) + " on Node " + to_string(jr.nodeid), 6);
             (*p_ar)(locations[node_locations[(int) jr.nodeid]]) << otf2::event::enter(otf2::chrono::convert_time_point(a), jr.region);
 
             /*
@@ -210,7 +210,7 @@ namespace Utils {
         for (uint i = 0; i < job_regions.size(); ++i) {
             if (job_regions[i].jobid == job_id) {
                 std::chrono::high_resolution_clock::duration dur = std::chrono::high_resolution_clock::duration((int) rsp->globalTime);
-                log->debug("OTF2 JobEnd  (" + to_string(job_id) + ") at " + itos(rsp->globalTime) + " on Node " + to_string(job_regions[i].nodeid), 6);
+                LOG_DEBUG(log, "OTF2 JobEnd  (" + to_string(job_id) + ") at " + itos(rsp->globalTime) + " on Node " + to_string(job_regions[i].nodeid), 6);
                 std::chrono::high_resolution_clock::time_point a = std::chrono::high_resolution_clock::time_point(dur);
                 (*p_ar)(locations[node_locations[job_regions[i].nodeid]]) << otf2::event::leave(otf2::chrono::convert_time_point(a), job_regions[i].region);
 
@@ -239,7 +239,7 @@ namespace Utils {
          */
 
         if (exists(tracepath) && is_directory(tracepath)) {
-            log->debug("tracepath: " + tracepath.native() + " exists and is a directory.", 1);
+            LOG_DEBUG(log, "tracepath: " + tracepath.native() + " exists and is a directory.", 1);
         }
 
         /*
@@ -253,48 +253,48 @@ namespace Utils {
         if (exists(tracename_otf2)) {
             bool res = remove(tracename_otf2);
             if (res) {
-                log->debug("tracename: " + tracename_otf2.native() + " was removed.", 1);
+                LOG_DEBUG(log, "tracename: " + tracename_otf2.native() + " was removed.", 1);
             } else {
-                log->debug("tracename: " + tracename_otf2.native() + " was not removed, there was an error.", 1);
+                LOG_DEBUG(log, "tracename: " + tracename_otf2.native() + " was not removed, there was an error.", 1);
             }
         } else {
-            log->debug("tracename: " + tracename_otf2.native() + " does not exist.", 1);
+            LOG_DEBUG(log, "tracename: " + tracename_otf2.native() + " does not exist.", 1);
         }
 
         path tracename_marker = path(tracedir + "/" + tracename + ".marker");
         if (exists(tracename_marker)) {
             bool res = remove(tracename_marker);
             if (res) {
-                log->debug("tracename: " + tracename_marker.native() + " was removed.", 1);
+                LOG_DEBUG(log, "tracename: " + tracename_marker.native() + " was removed.", 1);
             } else {
-                log->debug("tracename: " + tracename_marker.native() + " was not removed, there was an error.", 1);
+                LOG_DEBUG(log, "tracename: " + tracename_marker.native() + " was not removed, there was an error.", 1);
             }
         } else {
-            log->debug("tracename: " + tracename_marker.native() + " does not exist.", 1);
+            LOG_DEBUG(log, "tracename: " + tracename_marker.native() + " does not exist.", 1);
         }
 
         path tracename_def = path(tracedir + "/" + tracename + ".def");
         if (exists(tracename_def)) {
             bool res = remove(tracename_def);
             if (res) {
-                log->debug("tracename: " + tracename_def.native() + " was removed.", 1);
+                LOG_DEBUG(log, "tracename: " + tracename_def.native() + " was removed.", 1);
             } else {
-                log->debug("tracename: " + tracename_def.native() + " was not removed, there was an error.", 1);
+                LOG_DEBUG(log, "tracename: " + tracename_def.native() + " was not removed, there was an error.", 1);
             }
         } else {
-            log->debug("tracename: " + tracename_def.native() + " does not exist.", 1);
+            LOG_DEBUG(log, "tracename: " + tracename_def.native() + " does not exist.", 1);
         }
 
         path tracename_dir = path(tracedir + "/" + tracename);
         if (exists(tracename_dir) && is_directory(tracename_dir)) {
             bool res = remove_all(tracename_dir);
             if (res) {
-                log->debug("tracename: " + tracename_dir.native() + " was removed.", 1);
+                LOG_DEBUG(log, "tracename: " + tracename_dir.native() + " was removed.", 1);
             } else {
-                log->debug("tracename: " + tracename_dir.native() + " was not removed, there was an error.", 1);
+                LOG_DEBUG(log, "tracename: " + tracename_dir.native() + " was not removed, there was an error.", 1);
             }
         } else {
-            log->debug("tracename: " + tracename_dir.native() + " does not exist.", 1);
+            LOG_DEBUG(log, "tracename: " + tracename_dir.native() + " does not exist.", 1);
         }
 
 
@@ -313,7 +313,7 @@ namespace Utils {
         ar.set_post_flush_callback([]() {
             return otf2::chrono::convert_time_point(get_time()); });
         //
-        log->debug("callback set", 4);
+        LOG_DEBUG(log, "callback set", 4);
 
         /*
          * String definitions go in here.
@@ -337,7 +337,7 @@ namespace Utils {
 
 
         ar << strings;
-        log->debug("Pushed strings to archive", 1);
+        LOG_DEBUG(log, "Pushed strings to archive", 1);
 
 
         /*
@@ -346,7 +346,7 @@ namespace Utils {
          */
         otf2::definition::system_tree_node root_node(0, strings[8], strings[1]);
         ar << root_node;
-        log->debug("Pushed root_node to archive", 1);
+        LOG_DEBUG(log, "Pushed root_node to archive", 1);
 
 
         /*
@@ -359,7 +359,7 @@ namespace Utils {
             nodes.push_back(sub_node);
             ar << sub_node;
         }
-        log->debug("Pushed back sub_nodes & pushed to archive");
+        LOG_DEBUG(log, "Pushed back sub_nodes & pushed to archive", 1);
 
 
         //        log->debug("size of nodes is " + to_string(nodes.size()), 1);
@@ -370,7 +370,7 @@ namespace Utils {
         otf2::definition::clock_properties ac = otf2::definition::clock_properties(otf2::chrono::ticks(1), otf2::chrono::ticks(0), otf2::chrono::ticks(1));
         //        otf2::definition::clock_properties ac = otf2::definition::clock_properties(otf2::chrono::ticks(1), otf2::chrono::ticks(0));
         ar << ac;
-        log->debug("Pushed clock to archive", 1);
+        LOG_DEBUG(log, "Pushed clock to archive", 1);
         locations_used.resize(numNodes);
         node_locations.resize(numNodes);
 
@@ -390,7 +390,7 @@ namespace Utils {
     void otf2trace::simFinished(uint32_t finTime) {
         otf2::definition::clock_properties ac = otf2::definition::clock_properties(otf2::chrono::ticks(1), otf2::chrono::ticks(0), otf2::chrono::ticks(finTime + 60));
         (*p_ar) << ac;
-        log->debug("Pushed clock to archive at simFinished", 1);
+        LOG_DEBUG(log, "Pushed clock to archive at simFinished", 1);
     }
 
     void otf2trace::jobBeginCompute(int job_id) {
@@ -403,7 +403,7 @@ namespace Utils {
         for (uint i = 0; i < job_regions.size(); ++i) {
             if (job_regions[i].jobid == job_id) {
                 std::chrono::high_resolution_clock::duration dur = std::chrono::high_resolution_clock::duration((int) rsp->globalTime);
-                log->debug("OTF2 JobBeginCompute  (" + to_string(job_id) + ") at " + itos(rsp->globalTime) + " on Node " + to_string(job_regions[i].nodeid), 6);
+                LOG_DEBUG(log, "OTF2 JobBeginCompute  (" + to_string(job_id) + ") at " + itos(rsp->globalTime) + " on Node " + to_string(job_regions[i].nodeid), 6);
                 std::chrono::high_resolution_clock::time_point a = std::chrono::high_resolution_clock::time_point(dur);
                 (*p_ar)(locations[node_locations[job_regions[i].nodeid]]) << otf2::event::leave(otf2::chrono::convert_time_point(a), job_regions[i].region);
                 otf2::definition::region region(regioncount++, strings[10 + job_id], strings[5], strings[6], otf2::definition::region::role_type::function, otf2::definition::region::paradigm_type::user, otf2::definition::region::flags_type::none, strings[7], 0, 0);
@@ -425,7 +425,7 @@ namespace Utils {
         for (uint i = 0; i < job_regions.size(); ++i) {
             if (job_regions[i].jobid == job_id) {
                 std::chrono::high_resolution_clock::duration dur = std::chrono::high_resolution_clock::duration((int) rsp->globalTime);
-                log->debug("OTF2 JobEndCompute  (" + to_string(job_id) + ") at " + itos(rsp->globalTime) + " on Node " + to_string(job_regions[i].nodeid), 6);
+                LOG_DEBUG(log, "OTF2 JobEndCompute  (" + to_string(job_id) + ") at " + itos(rsp->globalTime) + " on Node " + to_string(job_regions[i].nodeid), 6);
                 std::chrono::high_resolution_clock::time_point a = std::chrono::high_resolution_clock::time_point(dur);
                 (*p_ar)(locations[node_locations[job_regions[i].nodeid]]) << otf2::event::leave(otf2::chrono::convert_time_point(a), job_regions[i].region);
                 otf2::definition::region region(regioncount++, strings[10 + job_id], strings[5], strings[6], otf2::definition::region::role_type::file_io, otf2::definition::region::paradigm_type::user, otf2::definition::region::flags_type::none, strings[7], 0, 0);
@@ -46,11 +46,14 @@ namespace Utils {
          */
         
         
+        doc = NULL;
         ConfigFile = "$PWD/simulation_configuration.xml";
         StatisticsConfigFile = "$PWD/statistics_configuration.xml";
         ErrorFilePath = "$PWD/logs/error.log";
         DebugFilePath = "$PWD/logs/debug.log";
         DebugLevel = 1;
+        DebugRingBufferSize = 0;
+        DebugAsyncWriter = false;
 
         DSCPparaverOutPutDir = "";
         DSCPparaverTrace = "";
@@ -83,6 +86,13 @@ namespace Utils {
         computeEnergy = false;
 
         collectStatisticsInterval = 10 * 60;
+        eventQueueType = HEAP_EVENT_QUEUE;
+        nodePools = false;
+        earliestStartSearch = false;
+        scheduleArrivalsOnly = false;
+        partitionThreads = 1;
+        partitionEventStreams = false;
+        partitionLookahead = 3600;
 
         numberOfReservations = -1;
         malleableExpand = false;
@@ -119,6 +129,21 @@ namespace Utils {
         
         SLURMWQsize = 10;
         SLURMPmem = 0;
+        SLURMAgeInterval = 60;
+        SLURMWeightAge = 0;
+        SLURMWeightFairShare = 0;
+        SLURMWeightJobSize = 0;
+        SLURMWeightPartition = 0;
+        SLURMWeightQOS = 0;
+        SLURMMaxAge = 7 * 24 * 3600;
+        SLURMDecayHalfLife = 7 * 24 * 3600;
+        SLURMCalcPeriod = 5 * 60;
+        SLURMFavorSmall = false;
+        SLURMBackfillInterval = 0;
+        SLURMBackfillResolution = 60;
+        SLURMBackfillMaxJobTest = 500;
+        SLURMBackfillMaxJobUser = 0;
+        SLURMBackfillThreads = 1;
 
 
 
@@ -298,6 +323,21 @@ namespace Utils {
             DebugFilePath = "./logs/debug.log";
         }
         log->debugConfig("DebugFilePath = " + DebugFilePath);
+
+        //DebugRingBufferSize
+        DebugRingBufferSize = atoi((getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/DebugRingBufferSize", this->doc)).c_str());
+        log->debugConfig("DebugRingBufferSize = " + to_string(DebugRingBufferSize));
+
+        //DebugAsyncWriter
+        string debugAsyncWriter_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/DebugAsyncWriter", this->doc);
+
+        if (!debugAsyncWriter_s.compare("") || !debugAsyncWriter_s.compare("NO")) {
+            this->DebugAsyncWriter = false;
+            log->debugConfig("DebugAsyncWriter = FALSE");
+        } else {
+            this->DebugAsyncWriter = true;
+            log->debugConfig("DebugAsyncWriter = TRUE");
+        }
         
 
         //ErrorFilePath
@@ -377,9 +417,64 @@ namespace Utils {
             log->debugConfig("reserveFullNode = TRUE");
         }
 
+        //nodePools
+        string nodePools_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/NodePools", this->doc);
+
+        if (!nodePools_s.compare("") || !nodePools_s.compare("NO")) {
+            this->nodePools = false;
+            log->debugConfig("nodePools = FALSE");
+        } else {
+            this->nodePools = true;
+            log->debugConfig("nodePools = TRUE");
+        }
+
+        //earliestStartSearch
+        string earliestStartSearch_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/EarliestStartSearch", this->doc);
+
+        if (!earliestStartSearch_s.compare("") || !earliestStartSearch_s.compare("NO")) {
+            this->earliestStartSearch = false;
+            log->debugConfig("earliestStartSearch = FALSE");
+        } else {
+            this->earliestStartSearch = true;
+            log->debugConfig("earliestStartSearch = TRUE");
+        }
+
+        //scheduleArrivalsOnly
+        string scheduleArrivalsOnly_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/ScheduleArrivalsOnly", this->doc);
+
+        if (!scheduleArrivalsOnly_s.compare("") || !scheduleArrivalsOnly_s.compare("NO")) {
+            this->scheduleArrivalsOnly = false;
+            log->debugConfig("scheduleArrivalsOnly = FALSE");
+        } else {
+            this->scheduleArrivalsOnly = true;
+            log->debugConfig("scheduleArrivalsOnly = TRUE");
+        }
+
         
 
 
+        //partitionThreads
+        string partitionThreads_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/PartitionThreads", this->doc);
+        if (partitionThreads_s.compare(""))
+            this->partitionThreads = atoi(partitionThreads_s.c_str());
+        log->debugConfig("partitionThreads = " + itos(this->partitionThreads));
+
+        //partitionEventStreams
+        string partitionEventStreams_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/PartitionEventStreams", this->doc);
+        if (!partitionEventStreams_s.compare("") || !partitionEventStreams_s.compare("NO")) {
+            this->partitionEventStreams = false;
+            log->debugConfig("partitionEventStreams = FALSE");
+        } else {
+            this->partitionEventStreams = true;
+            log->debugConfig("partitionEventStreams = TRUE");
+        }
+
+        //partitionLookahead
+        string partitionLookahead_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/PartitionLookahead", this->doc);
+        if (partitionLookahead_s.compare(""))
+            this->partitionLookahead = atof(partitionLookahead_s.c_str());
+        log->debugConfig("partitionLookahead = " + ftos(this->partitionLookahead));
+
         //computeEnergy
         string computeEnergy_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/computeEnergy", this->doc);
 
@@ -397,6 +492,18 @@ namespace Utils {
 
         if (collectStatisticsInterval == 0) collectStatisticsInterval = 18000;
 
+        //EventQueue
+        string eventQueue_s = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/EventQueue", this->doc);
+        if (eventQueue_s == "CALENDAR") {
+            this->eventQueueType = CALENDAR_EVENT_QUEUE;
+        } else {
+            if (eventQueue_s != "" && eventQueue_s != "HEAP")
+                log->error("Unknown EventQueue " + eventQueue_s + ", the heap event queue will be used");
+            eventQueue_s = "HEAP";
+            this->eventQueueType = HEAP_EVENT_QUEUE;
+        }
+        log->debugConfig("EventQueue = " + eventQueue_s);
+
         //jobRequirementsFile
         jobRequirementsFile = getStringFromXPathExpression("/SimulationConfiguration/Policy/Common/jobRequirementsFile", this->doc);
         log->debugConfig("jobRequirementsFile = " + jobRequirementsFile);
@@ -512,6 +619,8 @@ namespace Utils {
      * The default destructor for the class
      */
     SimulationConfiguration::~SimulationConfiguration() {
+        if (this->doc != NULL)
+            xmlFreeDoc(this->doc);
     }
 
     /**
@@ -682,6 +791,23 @@ namespace Utils {
         return ResourceSelectionPolicy;
     }
 
+    /**
+     * Given a comma separated list of priorities returns them
+     * @param priorities The priorities in string format
+     * @return The priorities, empty if the string is empty
+     */
+    vector<double> SimulationConfiguration::getPriorityList(string priorities) {
+        vector<double> list;
+        if (priorities == "")
+            return list;
+
+        deque<string> fields;
+        SplitLine(priorities, ",", fields);
+        for (deque<string>::iterator it = fields.begin(); it != fields.end(); ++it)
+            list.push_back(atof(it->c_str()));
+        return list;
+    }
+
     /**
      * Given an string returns the metric type
      * @param variable The metric type in string format
@@ -830,6 +956,47 @@ namespace Utils {
         string PersistentMemory_s = getStringFromXPathExpression("/ModelPersistentMemory", slurmDoc);
         int PersistentMemory = atoi(PersistentMemory_s.c_str());
 
+        //seconds per point of age priority, the default one is kept when it is not given
+        string PriorityAgeInterval_s = getStringFromXPathExpression("/PriorityAgeInterval", slurmDoc);
+        double PriorityAgeInterval = PriorityAgeInterval_s.compare("") ? atof(PriorityAgeInterval_s.c_str()) : SLURMAgeInterval;
+        log->debugConfig("SLURM PriorityAgeInterval = " + ftos(PriorityAgeInterval));
+
+        //multifactor priority, it is used when any of the weights is not 0
+        double PriorityWeightAge = atof(getStringFromXPathExpression("/PriorityWeightAge", slurmDoc).c_str());
+        double PriorityWeightFairshare = atof(getStringFromXPathExpression("/PriorityWeightFairshare", slurmDoc).c_str());
+        double PriorityWeightJobSize = atof(getStringFromXPathExpression("/PriorityWeightJobSize", slurmDoc).c_str());
+        double PriorityWeightPartition = atof(getStringFromXPathExpression("/PriorityWeightPartition", slurmDoc).c_str());
+        double PriorityWeightQOS = atof(getStringFromXPathExpression("/PriorityWeightQOS", slurmDoc).c_str());
+        log->debugConfig("SLURM PriorityWeights age = " + ftos(PriorityWeightAge) + " fairshare = " + ftos(PriorityWeightFairshare) + " jobsize = " + ftos(PriorityWeightJobSize) + " partition = " + ftos(PriorityWeightPartition) + " qos = " + ftos(PriorityWeightQOS));
+
+        string PriorityMaxAge_s = getStringFromXPathExpression("/PriorityMaxAge", slurmDoc);
+        double PriorityMaxAge = PriorityMaxAge_s.compare("") ? atof(PriorityMaxAge_s.c_str()) : SLURMMaxAge;
+        string PriorityDecayHalfLife_s = getStringFromXPathExpression("/PriorityDecayHalfLife", slurmDoc);
+        double PriorityDecayHalfLife = PriorityDecayHalfLife_s.compare("") ? atof(PriorityDecayHalfLife_s.c_str()) : SLURMDecayHalfLife;
+        string PriorityCalcPeriod_s = getStringFromXPathExpression("/PriorityCalcPeriod", slurmDoc);
+        double PriorityCalcPeriod = PriorityCalcPeriod_s.compare("") ? atof(PriorityCalcPeriod_s.c_str()) : SLURMCalcPeriod;
+        string PriorityFavorSmall_s = getStringFromXPathExpression("/PriorityFavorSmall", slurmDoc);
+        bool PriorityFavorSmall = !(!PriorityFavorSmall_s.compare("") || !PriorityFavorSmall_s.compare("NO"));
+        log->debugConfig("SLURM PriorityMaxAge = " + ftos(PriorityMaxAge) + " PriorityDecayHalfLife = " + ftos(PriorityDecayHalfLife) + " PriorityCalcPeriod = " + ftos(PriorityCalcPeriod) + " PriorityFavorSmall = " + btos(PriorityFavorSmall));
+
+        //priorities of the partitions and of the QOS, comma separated and indexed by the partition and queue numbers of the jobs
+        vector<double> PartitionPriorities = getPriorityList(getStringFromXPathExpression("/PartitionPriorities", slurmDoc));
+        vector<double> QOSPriorities = getPriorityList(getStringFromXPathExpression("/QOSPriorities", slurmDoc));
+
+        //backfill cycles as the sched/backfill plugin, bf_interval, bf_resolution, bf_max_job_test and bf_max_job_user
+        double BackfillInterval = atof(getStringFromXPathExpression("/BackfillInterval", slurmDoc).c_str());
+        string BackfillResolution_s = getStringFromXPathExpression("/BackfillResolution", slurmDoc);
+        double BackfillResolution = BackfillResolution_s.compare("") ? atof(BackfillResolution_s.c_str()) : SLURMBackfillResolution;
+        string BackfillMaxJobTest_s = getStringFromXPathExpression("/BackfillMaxJobTest", slurmDoc);
+        int BackfillMaxJobTest = BackfillMaxJobTest_s.compare("") ? atoi(BackfillMaxJobTest_s.c_str()) : SLURMBackfillMaxJobTest;
+        int BackfillMaxJobUser = atoi(getStringFromXPathExpression("/BackfillMaxJobUser", slurmDoc).c_str());
+        log->debugConfig("SLURM BackfillInterval = " + ftos(BackfillInterval) + " BackfillResolution = " + ftos(BackfillResolution) + " BackfillMaxJobTest = " + itos(BackfillMaxJobTest) + " BackfillMaxJobUser = " + itos(BackfillMaxJobUser));
+
+        //threads that check at once if the backfill candidates can start now, 1 checks them one after the other
+        string BackfillThreads_s = getStringFromXPathExpression("/BackfillThreads", slurmDoc);
+        int BackfillThreads = BackfillThreads_s.compare("") ? atoi(BackfillThreads_s.c_str()) : SLURMBackfillThreads;
+        log->debugConfig("SLURM BackfillThreads = " + itos(BackfillThreads));
+
         //malleablility
         bool malexpand = false;
         bool malshrink = false;
@@ -848,6 +1015,23 @@ namespace Utils {
             SLURMWQsize = WQScheduleDepth;
             SLURMSkipTime = SchedulerSkipTime;
             SLURMPmem = PersistentMemory;
+            SLURMAgeInterval = PriorityAgeInterval;
+            SLURMWeightAge = PriorityWeightAge;
+            SLURMWeightFairShare = PriorityWeightFairshare;
+            SLURMWeightJobSize = PriorityWeightJobSize;
+            SLURMWeightPartition = PriorityWeightPartition;
+            SLURMWeightQOS = PriorityWeightQOS;
+            SLURMMaxAge = PriorityMaxAge;
+            SLURMDecayHalfLife = PriorityDecayHalfLife;
+            SLURMCalcPeriod = PriorityCalcPeriod;
+            SLURMFavorSmall = PriorityFavorSmall;
+            SLURMPartitionPriorities = PartitionPriorities;
+            SLURMQOSPriorities = QOSPriorities;
+            SLURMBackfillInterval = BackfillInterval;
+            SLURMBackfillResolution = BackfillResolution;
+            SLURMBackfillMaxJobTest = BackfillMaxJobTest;
+            SLURMBackfillMaxJobUser = BackfillMaxJobUser;
+            SLURMBackfillThreads = BackfillThreads;
         } else {
             //the architecture, the log and the startime will have to be set for other functionality
             return (SLURMSchedulingPolicy*) this->CreateSLURMPolicy(architectureConfig, this->log, 0, SimulateResourceUsageCur, numberOfReservations, malexpand, malshrink);
@@ -1046,6 +1230,8 @@ namespace Utils {
         else
             printf("Some errors has occurred when loading the resource trace file .. please check the error log.\n");
 
+        workloadRet->buildDependencies();
+
         return workloadRet;
     }
 
@@ -138,6 +138,7 @@ namespace Utils {
         //stuff for parsing types
         policy_type_t getPolicyType(string spolicy);
         RS_policy_type_t getResourceSelectionPolicyType(string spolicy);
+        vector<double> getPriorityList(string priorities);
         architecture_type_t getArchitectureType(string arch);
         statistic_t getStatisticType(string estimator);
         metric_t getMetricType(string variable);
@@ -168,12 +169,15 @@ namespace Utils {
         string DebugFilePath; /**< The pathfile for the debug file */
         int DebugLevel; /**< The debug level used in the simulation */
         int DebugFrom; /**< From what line we will start dumping files */
+        int DebugRingBufferSize; /**< If greater than 0, only the last DebugRingBufferSize MB of debug output are kept in memory, they are written on exit or crash */
+        bool DebugAsyncWriter; /**< Indicates if the debug file is written by a background thread */
         string GlobalStatisticsOutputFile; /**< The path for the output simulation statistics file */
         string JobsSimPerformanceCSVFile; /**< The path for the output cvs file that will contain the information for the simulated jobs  */
         string PolicySimPerformanceCSVFile; /**< The path for the output cvs file that will contain the ifnroamtion for the policies*/
         string SWFOutputFile; /**< The path for the output trace in SWF format.*/
 
         double collectStatisticsInterval; /**< The interval between to statistical collection events  */
+        event_queue_type_t eventQueueType; /**< The implementation of the event queue, the calendar queue is faster for traces with times in whole seconds */
         string jobRequirementsFile; /**< The filepath for the job requirements files */
         double EmulateCPUFactor; /**<see scheduling policy for its definition.*/
         double ArrivalFactor; /**<indicates if the submitt time has to be multiplied by a factor*/
@@ -203,6 +207,12 @@ namespace Utils {
         bool generateSWF; /**<Indicates if the swf trace of the execution must be generated.*/
         bool simPartitions; /**<Indicates if partitions must be simulated. */
         bool reserveFullNode; /**<Indicates if a job reserves only full nodes or not. If true, a job can only reserve multiples of a node. If false, a job can reserve a portion of a node, i.e., jobs can share resources within a node.*/
+        bool nodePools; /**<Indicates if the reservation tables group the nodes with the same state in pools that share a single timeline. It saves memory and time with many identical nodes.*/
+        bool earliestStartSearch; /**<Indicates if the allocation searches jump to the first time when the whole system has enough free resources for the job, with the capacity profile. The nodes are still checked one by one there, but the jobs can start earlier than with the instants that the per-node search explores.*/
+        bool scheduleArrivalsOnly; /**<Indicates if an FCFS pass with nothing new but arrivals since the last one only schedules the new jobs, behind the reservations of the last pass. A finish, an early termination or a backfilled start still runs a full pass over the whole queue. The schedules are the same as with full passes.*/
+        int partitionThreads; /**<The threads that schedule the partitions at once. With more than one every partition keeps its nodes in a store of its own, the schedules are the same as with one.*/
+        bool partitionEventStreams; /**<Indicates if every partition runs its own event stream, in the threads of PartitionThreads. The logical processes wait for each other at the statistics collections and at the end of every lookahead window.*/
+        double partitionLookahead; /**<The seconds of simulated time that the logical processes of the partitions advance between two barriers, if there is no statistics collection before. 0 lets them run up to the next collection, or to the end if there is none.*/
 
         /*specific parameters for each policy .. if this field list grows a lot we may create subclasses */
         metric_t DSCPmetricType; /**< The metric to optmize in case that the deepsearchcollisionpolicy is used (@see deepsearchcollisionpolicy)*/
@@ -243,6 +253,23 @@ namespace Utils {
         int SLURMWQsize;
         int SLURMSkipTime;
         int SLURMPmem;
+        double SLURMAgeInterval;
+        double SLURMWeightAge;
+        double SLURMWeightFairShare;
+        double SLURMWeightJobSize;
+        double SLURMWeightPartition;
+        double SLURMWeightQOS;
+        double SLURMMaxAge;
+        double SLURMDecayHalfLife;
+        double SLURMCalcPeriod;
+        bool SLURMFavorSmall;
+        vector<double> SLURMPartitionPriorities;
+        vector<double> SLURMQOSPriorities;
+        double SLURMBackfillInterval;
+        double SLURMBackfillResolution;
+        int SLURMBackfillMaxJobTest;
+        int SLURMBackfillMaxJobUser;
+        int SLURMBackfillThreads;
         
     };
 
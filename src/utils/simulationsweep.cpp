@@ -0,0 +1,403 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <utils/simulationsweep.h>
+#include <utils/simulationconfiguration.h>
+#include <utils/utilities.h>
+#include <utils/threadpool.h>
+#include <scheduling/copiedtracefile.h>
+#include <scheduling/systemorchestrator.h>
+#include <statistics/processnormal.h>
+#include <statistics/processuniform.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace Utils {
+
+    /**
+     * Does a replica of a run of the sweep in a thread of the pool
+     */
+    class SweepRunTask : public ThreadPoolTask {
+    public:
+
+        SweepRunTask(SimulationSweep* sweep, const SweepRun* sweepRun, uint32_t replica, SweepResult* result) : sweep(sweep), sweepRun(sweepRun), replica(replica), result(result) {
+        }
+
+        void run() override {
+            this->sweep->simulate(*this->sweepRun, this->replica, this->result);
+        }
+
+        SimulationSweep* sweep; /**< The sweep of the run */
+        const SweepRun* sweepRun; /**< The run to do */
+        uint32_t replica; /**< The replica of the run */
+        SweepResult* result; /**< Where the results of the replica are left */
+    };
+
+    /**
+     * Owns the objects of a replica of a run and frees them when the replica ends. The architecture frees the system
+     * orchestrator, with its partitions, policies and reservation tables, and then the nodes. The log goes last, as the
+     * policies write to it when they are destroyed.
+     */
+    class SweepRunContext {
+    public:
+
+        SweepRunContext() : faketime(0), log(NULL), simConfig(NULL), architectureConfig(NULL), workload(NULL), statistics(NULL), chars(NULL), simulation(NULL) {
+        }
+
+        ~SweepRunContext() {
+            //the time of the simulation goes with it
+            if (this->log != NULL)
+                this->log->setglobalTimeref(&this->faketime);
+            delete this->simulation;
+            delete this->chars;
+            delete this->statistics;
+            delete this->architectureConfig;
+            delete this->workload;
+            delete this->simConfig;
+            delete this->log;
+        }
+
+        SweepRunContext(const SweepRunContext&) = delete;
+        SweepRunContext& operator=(const SweepRunContext&) = delete;
+
+        uint64_t faketime; /**< The time of the log until the simulation is created */
+        Log* log; /**< The log of the replica */
+        SimulationConfiguration* simConfig; /**< The configuration with the parameters of the run */
+        ArchitectureConfiguration* architectureConfig; /**< The architecture, it owns the system orchestrator */
+        CopiedTraceFile* workload; /**< The copy of the jobs */
+        SimStatistics* statistics; /**< The statistics of the simulation */
+        SimulatorCharacteristics* chars; /**< The characteristics passed to the simulation */
+        Simulation* simulation; /**< The simulation */
+    };
+
+    /**
+     * The constructor for the class, loads the sweep definition and parses the workload of the simulation configuration
+     * @param SweepFilePath The sweep definition file path
+     * @param SimulationConfigurationFilePath The simulation configuration that all the runs share
+     * @param log The logging engine
+     */
+    SimulationSweep::SimulationSweep(string SweepFilePath, string SimulationConfigurationFilePath, Log* log) {
+        this->SweepFilePath = expandFileName(SweepFilePath);
+        this->SimulationConfigurationFilePath = SimulationConfigurationFilePath;
+        this->log = log;
+        this->workload = NULL;
+
+        //Init XML2 Lib Parser
+        xmlInitParser();
+        //Parse the Xml document
+        this->doc = xmlParseFile(this->SweepFilePath.c_str());
+
+        if (this->doc == NULL) {
+            cout << "[SimulationSweep] Error when openening " << this->SweepFilePath << endl;
+            exit(1);
+        }
+
+        string threads_s = getStringFromXPathExpression("/SimulationSweep/Threads", this->doc);
+        this->threads = threads_s.compare("") ? atoi(threads_s.c_str()) : 1;
+        if (this->threads < 1)
+            this->threads = 1;
+        this->OutputFile = expandFileName(getStringFromXPathExpression("/SimulationSweep/OutputFile", this->doc));
+        if (this->OutputFile == "")
+            this->OutputFile = "sweep.csv";
+        log->debugConfig("[SimulationSweep] Threads = " + itos(this->threads) + " OutputFile = " + this->OutputFile);
+
+        //replication, every replica perturbs the workload with its own stream
+        string replications_s = getStringFromXPathExpression("/SimulationSweep/Replications", this->doc);
+        this->replications = (replications_s.compare("") && atoi(replications_s.c_str()) > 1) ? atoi(replications_s.c_str()) : 1;
+        string seed_s = getStringFromXPathExpression("/SimulationSweep/Seed", this->doc);
+        this->seed = seed_s.compare("") ? strtoull(seed_s.c_str(), NULL, 10) : DEFAULT_RANDOM_SEED;
+        this->runtimeVariation = atof(getStringFromXPathExpression("/SimulationSweep/RuntimeVariation", this->doc).c_str());
+        this->arrivalJitter = atof(getStringFromXPathExpression("/SimulationSweep/ArrivalJitter", this->doc).c_str());
+        log->debugConfig("[SimulationSweep] Replications = " + itos(this->replications) + " Seed = " + to_string(this->seed) + " RuntimeVariation = " + ftos(this->runtimeVariation) + " ArrivalJitter = " + ftos(this->arrivalJitter));
+        if (this->replications > 1 && this->runtimeVariation <= 0 && this->arrivalJitter <= 0)
+            log->error("The replicas of the sweep " + this->SweepFilePath + " are not perturbed, set RuntimeVariation or ArrivalJitter, they will all give the same results.");
+
+        xmlNodeSetPtr runNodes = getNodeSetFromXPathExpression("/SimulationSweep/Run", this->doc);
+
+        for (int i = 0; runNodes && i < runNodes->nodeNr; i++) {
+            xmlDocPtr runDoc = (xmlDocPtr) runNodes->nodeTab[i];
+
+            SweepRun sweepRun;
+            sweepRun.name = getStringFromXPathExpression("/Name", runDoc);
+            if (sweepRun.name == "")
+                sweepRun.name = "run" + itos(i + 1);
+            sweepRun.SLURMWQsize = getStringFromXPathExpression("/SLURMWQsize", runDoc);
+            sweepRun.SLURMSkipTime = getStringFromXPathExpression("/SLURMSkipTime", runDoc);
+            sweepRun.numberOfReservations = getStringFromXPathExpression("/NumberOfReservations", runDoc);
+            sweepRun.ArrivalFactor = getStringFromXPathExpression("/ArrivalFactor", runDoc);
+            sweepRun.architectureFile = getStringFromXPathExpression("/ArchitectureFile", runDoc);
+            log->debugConfig("[SimulationSweep] Loading the run " + sweepRun.name);
+            this->runs.push_back(sweepRun);
+        }
+        xmlXPathFreeNodeSet(runNodes);
+
+        //the workload is the same for all the runs, it is parsed once
+        SimulationConfiguration* simConfig = new SimulationConfiguration(this->SimulationConfigurationFilePath, log, NULL);
+        simConfig->log = log;
+        log->debug("[SimulationSweep] Using the workload " + simConfig->workloadPath, 1);
+        this->workload = simConfig->CreateWorkload(log);
+        delete simConfig;
+    }
+
+    /**
+     * The destructor for the class
+     */
+    SimulationSweep::~SimulationSweep() {
+        xmlFreeDoc(this->doc);
+    }
+
+    /**
+     * Does all the runs of the sweep and writes their results
+     * @return True if the results have been written
+     */
+    bool SimulationSweep::run() {
+        if (this->runs.empty()) {
+            log->error("The sweep " + this->SweepFilePath + " has no runs.");
+            return false;
+        }
+        cout << "Sweeping " << this->runs.size() << " runs with " << this->replications << " replicas of " << this->SimulationConfigurationFilePath << " in " << this->threads << " threads" << endl;
+
+        //the replicas of a run are consecutive in the results
+        vector<SweepResult> results(this->runs.size() * this->replications);
+        vector<SweepRunTask> tasks;
+        vector<ThreadPoolTask*> pending;
+        tasks.reserve(results.size());
+        for (uint32_t i = 0; i < this->runs.size(); i++)
+            for (uint32_t r = 0; r < this->replications; r++) {
+                tasks.push_back(SweepRunTask(this, &this->runs[i], r, &results[i * this->replications + r]));
+                pending.push_back(&tasks.back());
+            }
+        ThreadPool pool(this->threads);
+        pool.run(pending);
+
+        return this->saveResults(results);
+    }
+
+    /**
+     * Does a replica of a run of the sweep. The replica gets its own configuration, architecture, policy and copy of the
+     * workload, the creation of the replicas is serialized and the simulations are done at once. All of them are freed when
+     * the replica ends. The replica does not generate the summary nor the statistics files of a simulation, its results
+     * are left for the CSV of the sweep.
+     * @param sweepRun The run to do
+     * @param replica The replica of the run, it selects the stream that perturbs the workload
+     * @param result Where the results of the replica are left
+     */
+    void SimulationSweep::simulate(const SweepRun& sweepRun, uint32_t replica, SweepResult* result) {
+        auto start = std::chrono::steady_clock::now();
+        SweepRunContext context;
+        context.log = new Log("", "", 1, 1, false, &context.faketime, true);
+        Log* runLog = context.log;
+        SimulationConfiguration* simConfig;
+        ArchitectureConfiguration* architectureConfig;
+        SystemOrchestrator* sysOrch;
+        CopiedTraceFile* runWorkload;
+        SimStatistics* statistics;
+        SimulatorCharacteristics* chars;
+        Simulation* simulation;
+
+        {
+            std::lock_guard<std::mutex> lock(this->setupMutex);
+            simConfig = context.simConfig = new SimulationConfiguration(this->SimulationConfigurationFilePath, runLog, NULL);
+            simConfig->log = runLog;
+            if (sweepRun.SLURMWQsize.compare(""))
+                simConfig->SLURMWQsize = atoi(sweepRun.SLURMWQsize.c_str());
+            if (sweepRun.SLURMSkipTime.compare(""))
+                simConfig->SLURMSkipTime = atoi(sweepRun.SLURMSkipTime.c_str());
+            if (sweepRun.numberOfReservations.compare(""))
+                simConfig->numberOfReservations = atoi(sweepRun.numberOfReservations.c_str());
+            if (sweepRun.ArrivalFactor.compare(""))
+                simConfig->ArrivalFactor = atof(sweepRun.ArrivalFactor.c_str());
+            if (sweepRun.architectureFile.compare(""))
+                simConfig->architectureFile = sweepRun.architectureFile;
+            //the output trace is written in time order for a single simulation
+            simConfig->generateOutputTrace = false;
+
+            architectureConfig = context.architectureConfig = simConfig->CreateArchitecture(runLog, 0);
+            sysOrch = architectureConfig->getSystemOrchestrator();
+            sysOrch->setSimulatePartitions(simConfig->simPartitions);
+            sysOrch->setPartitionThreads((simConfig->partitionThreads > 1) ? simConfig->partitionThreads : 1);
+            sysOrch->setGlobalTime(0);
+            sysOrch->setOutputTrace(false);
+            sysOrch->setsimuConfig(simConfig);
+            SchedulingPolicy* policy = simConfig->CreatePolicy(architectureConfig, runLog, 0);
+            sysOrch->setPolicy((ResourceSchedulingPolicy*) policy);
+            sysOrch->setReserveFullNode(simConfig->reserveFullNode);
+            sysOrch->setNodePools(simConfig->nodePools);
+            sysOrch->setEarliestStartSearch(simConfig->earliestStartSearch);
+
+            runWorkload = context.workload = new CopiedTraceFile(this->workload, runLog);
+            StatisticsConfigurationFile statisticsConfig(simConfig->StatisticsConfigFile, runLog);
+            statistics = context.statistics = new SimStatistics(runLog);
+            statistics->setJobMetricsDefinition(statisticsConfig.getJobMetrics());
+            statistics->setPolicyMetricsDefinition(statisticsConfig.getPolicyMetrics());
+            chars = context.chars = new SimulatorCharacteristics();
+            chars->setWorkload(runWorkload);
+            chars->setArchConfiguration(architectureConfig);
+            chars->setSimStatistics(statistics);
+
+            simulation = context.simulation = new Simulation(chars, runLog, sysOrch);
+            runLog->setglobalTimeref(simulation->getGlobalTimeRef());
+            simulation->setCollectStatisticsInterval(simConfig->collectStatisticsInterval);
+            simulation->setArrivalFactor(simConfig->ArrivalFactor);
+            simulation->setSlowdownBound(simConfig->SlowdownBound);
+            simulation->setEventQueueType(simConfig->eventQueueType);
+            simulation->setBackfillInterval(simConfig->SLURMBackfillInterval);
+            simulation->setPartitionEventStreams(simConfig->partitionEventStreams);
+            simulation->setPartitionLookahead(simConfig->partitionLookahead);
+            simulation->setReportResults(false);
+            sysOrch->setSim(simulation);
+        }
+
+        if (this->runtimeVariation > 0 || this->arrivalJitter > 0)
+            this->perturbWorkload(runWorkload, replica);
+        simulation->initSimulation();
+        simulation->doSimulation();
+
+        const SimulationTotals& totals = simulation->getTotals();
+        double finished = simulation->getNumberOfFinishedJobs();
+        result->SLURMWQsize = simConfig->SLURMWQsize;
+        result->SLURMSkipTime = simConfig->SLURMSkipTime;
+        result->numberOfReservations = simConfig->numberOfReservations;
+        result->ArrivalFactor = simConfig->ArrivalFactor;
+        result->architectureFile = simConfig->architectureFile;
+        result->startedJobs = totals.startedJobs;
+        result->finishedJobs = finished;
+        result->backfilledJobs = simulation->backfillcounter;
+        result->averageWait = (finished > 0) ? totals.wait / finished : 0;
+        result->averageBSLD = (finished > 0) ? totals.slowdown / finished : 0;
+        result->makespan = simulation->getglobalTime() - sysOrch->getFirstStartTime();
+        result->utilization = (result->makespan > 0) ? totals.usage * 100 / (result->makespan * architectureConfig->getNumberCPUs()) : 0;
+        result->runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        cout << "Sweep run " << sweepRun.name << " replica " << replica << " finished in " << result->runtime << " seconds" << endl;
+    }
+
+    /**
+     * Perturbs the jobs of a replica with the stream of the replica. The runtimes are multiplied by a normal factor of mean 1,
+     * without going over the requested time, and the arrivals are moved up to arrivalJitter seconds in both directions.
+     * The jobs are visited in the order of their numbers, so a replica always gets the same workload.
+     * @param runWorkload The copy of the workload of the replica
+     * @param replica The replica
+     */
+    void SimulationSweep::perturbWorkload(TraceFile* runWorkload, uint32_t replica) {
+        RandomStream stream(this->seed, replica);
+        ProcessNormal runtimeFactor(1, (this->runtimeVariation > 0) ? this->runtimeVariation : 1);
+        runtimeFactor.SetRandomStream(stream.split());
+        ProcessUniform arrivalShift(0, (this->arrivalJitter > 0) ? 2 * this->arrivalJitter : 1);
+        arrivalShift.SetRandomStream(stream.split());
+
+        for (map<int, Job*>::iterator it = runWorkload->JobList.begin(); it != runWorkload->JobList.end(); ++it) {
+            Job* job = it->second;
+            if (this->runtimeVariation > 0 && job->getRunTime() > 0) {
+                double runtime = ceil(job->getRunTime() * max(runtimeFactor.DeltaProx(), 0.01));
+                if (job->getRequestedTime() > 0 && runtime > job->getRequestedTime())
+                    runtime = job->getRequestedTime();
+                job->setRunTime(runtime);
+            }
+            if (this->arrivalJitter > 0)
+                job->setJobSimSubmitTime(max(job->getJobSimSubmitTime() + arrivalShift.DeltaProx() - this->arrivalJitter, 0.0));
+        }
+    }
+
+    /**
+     * Returns the half width of the 95% confidence interval of the mean of some values, with the Student's t distribution
+     * @param values The values
+     * @param mean The mean of the values
+     * @return The half width of the interval, 0 with less than two values
+     */
+    double SimulationSweep::confidenceHalfWidth(const vector<double>& values, double mean) {
+        //the 0.975 quantiles of the t distribution for 1 to 30 degrees of freedom, the normal one is used beyond
+        static const double t975[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        size_t n = values.size();
+        if (n < 2)
+            return 0;
+        double squares = 0;
+        for (size_t i = 0; i < n; i++)
+            squares += (values[i] - mean) * (values[i] - mean);
+        double stdev = sqrt(squares / (n - 1));
+        double t = (n - 1 <= 30) ? t975[n - 2] : 1.960;
+        return t * stdev / sqrt((double) n);
+    }
+
+    /**
+     * Writes the results of the runs in the CSV file of the sweep, a line per run in the order of the sweep file. With
+     * replicas, every metric is the mean of the replicas of the run followed by the half width of its 95% confidence interval.
+     * @param results The results of the replicas, the replicas of a run are consecutive
+     * @return True if the file has been written
+     */
+    bool SimulationSweep::saveResults(const vector<SweepResult>& results) {
+        std::ofstream fout(this->OutputFile.c_str(), ios::trunc);
+        if (!fout.is_open()) {
+            log->error("The sweep results file " + this->OutputFile + " cannot be opened.");
+            return false;
+        }
+        cout << "Creating sweep results file " << this->OutputFile << endl;
+        fout.precision(10);
+        if (this->replications > 1) {
+            fout << "Run,SLURMWQsize,SLURMSkipTime,NumberOfReservations,ArrivalFactor,ArchitectureFile,Replications,"
+                    << "StartedJobs,StartedJobsCI95,FinishedJobs,FinishedJobsCI95,BackfilledJobs,BackfilledJobsCI95,AverageWait,AverageWaitCI95,"
+                    << "AverageBSLD,AverageBSLDCI95,Makespan,MakespanCI95,Utilization,UtilizationCI95,Runtime,RuntimeCI95" << endl;
+            for (uint32_t i = 0; i < this->runs.size(); i++) {
+                const SweepResult& first = results[i * this->replications];
+                fout << this->runs[i].name << "," << first.SLURMWQsize << "," << first.SLURMSkipTime << "," << first.numberOfReservations << ","
+                        << first.ArrivalFactor << "," << first.architectureFile << "," << this->replications;
+                vector<vector<double> > metrics(8);
+                for (uint32_t r = 0; r < this->replications; r++) {
+                    const SweepResult& result = results[i * this->replications + r];
+                    metrics[0].push_back(result.startedJobs);
+                    metrics[1].push_back(result.finishedJobs);
+                    metrics[2].push_back(result.backfilledJobs);
+                    metrics[3].push_back(result.averageWait);
+                    metrics[4].push_back(result.averageBSLD);
+                    metrics[5].push_back(result.makespan);
+                    metrics[6].push_back(result.utilization);
+                    metrics[7].push_back(result.runtime);
+                }
+                for (uint32_t m = 0; m < metrics.size(); m++) {
+                    double mean = 0;
+                    for (uint32_t r = 0; r < metrics[m].size(); r++)
+                        mean += metrics[m][r];
+                    mean /= metrics[m].size();
+                    fout << "," << mean << "," << this->confidenceHalfWidth(metrics[m], mean);
+                }
+                fout << endl;
+            }
+            fout.close();
+            return true;
+        }
+
+        fout << "Run,SLURMWQsize,SLURMSkipTime,NumberOfReservations,ArrivalFactor,ArchitectureFile,StartedJobs,FinishedJobs,BackfilledJobs,AverageWait,AverageBSLD,Makespan,Utilization,Runtime" << endl;
+        for (uint32_t i = 0; i < results.size(); i++) {
+            const SweepResult& result = results[i];
+            fout << this->runs[i].name << "," << result.SLURMWQsize << "," << result.SLURMSkipTime << "," << result.numberOfReservations << ","
+                    << result.ArrivalFactor << "," << result.architectureFile << "," << result.startedJobs << "," << result.finishedJobs << ","
+                    << result.backfilledJobs << "," << result.averageWait << "," << result.averageBSLD << "," << result.makespan << ","
+                    << result.utilization << "," << result.runtime << endl;
+        }
+        fout.close();
+        return true;
+    }
+
+}
@@ -0,0 +1,108 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef UTILSSIMULATIONSWEEP_H
+#define UTILSSIMULATIONSWEEP_H
+
+#include <scheduling/tracefile.h>
+#include <statistics/randomstream.h>
+#include <utils/log.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* libxml2 stuff */
+#include <libxml/tree.h>
+#include <libxml/parser.h>
+
+using namespace Simulator;
+using namespace Statistics;
+using namespace std;
+using std::vector;
+
+namespace Utils {
+
+    /** A run of a sweep as it is written in the sweep file, the parameters that are empty keep the value of the simulation configuration file */
+    struct SweepRun {
+        string name; /**< The name of the run in the results */
+        string SLURMWQsize; /**< The SLURM wait queue size */
+        string SLURMSkipTime; /**< The SLURM skip time */
+        string numberOfReservations; /**< The number of reservations of the policy */
+        string ArrivalFactor; /**< The factor of the submit times */
+        string architectureFile; /**< The architecture definition */
+    };
+
+    /** The results of a run of a sweep, with the values of the parameters that it used */
+    struct SweepResult {
+        int SLURMWQsize; /**< The SLURM wait queue size */
+        int SLURMSkipTime; /**< The SLURM skip time */
+        int numberOfReservations; /**< The number of reservations of the policy */
+        double ArrivalFactor; /**< The factor of the submit times */
+        string architectureFile; /**< The architecture definition */
+        double startedJobs; /**< The number of started jobs */
+        double finishedJobs; /**< The number of finished jobs */
+        double backfilledJobs; /**< The number of jobs started by the backfill */
+        double averageWait; /**< The average wait time of the finished jobs */
+        double averageBSLD; /**< The average bounded slowdown of the finished jobs */
+        double makespan; /**< The time from the first start to the end of the simulation */
+        double utilization; /**< The percentage of the CPU time used by the finished jobs */
+        double runtime; /**< The seconds that the run took */
+    };
+
+    /**
+     * Runs the same simulation configuration many times with some parameters changed. The workload is parsed only once and
+     * every run simulates its own copy of the jobs, the runs are done at once in a thread pool and their results are written
+     * in a single CSV file.
+     * A run can be replicated, every replica perturbs the runtimes and the arrivals of its copy of the jobs with its own random
+     * stream, and the results are the means of the replicas with their 95% confidence intervals. The replica r of all the runs
+     * uses the same stream, so the runs are compared under the same perturbations.
+     */
+    class SimulationSweep {
+    public:
+        SimulationSweep(string SweepFilePath, string SimulationConfigurationFilePath, Log* log);
+        ~SimulationSweep();
+
+        bool run();
+        void simulate(const SweepRun& run, uint32_t replica, SweepResult* result);
+
+    private:
+        bool saveResults(const vector<SweepResult>& results);
+        void perturbWorkload(TraceFile* runWorkload, uint32_t replica);
+        double confidenceHalfWidth(const vector<double>& values, double mean);
+
+        xmlDocPtr doc; /**< XML containing the definition of the sweep */
+        string SweepFilePath; /**< The sweep definition file path */
+        string SimulationConfigurationFilePath; /**< The simulation configuration that all the runs share */
+        string OutputFile; /**< The CSV file where the results are written */
+        int threads; /**< The number of runs done at once */
+        uint32_t replications; /**< The number of replicas of every run */
+        uint64_t seed; /**< The seed of the streams of the replicas */
+        double runtimeVariation; /**< The coefficient of variation of the normal factor applied to the runtimes of the replicas, 0 keeps them */
+        double arrivalJitter; /**< The maximum number of seconds that the arrivals of the replicas are moved, 0 keeps them */
+        vector<SweepRun> runs; /**< The runs of the sweep */
+        TraceFile* workload; /**< The parsed workload, it is only read by the runs */
+        Log* log; /**< The logging engine */
+        std::mutex setupMutex; /**< Serializes the creation of the runs, the configuration parser and the factories are not thread safe */
+    };
+
+}
+
+#endif
@@ -161,10 +161,30 @@ namespace Utils {
     void SLURMJobQueue::clear() {
         this->queue.clear();
     }
+
+    /**
+     * Sets how fast the priority of the jobs grows with their age, it can only be changed while the queue is empty
+     * @param ageInterval The seconds that a job has to wait to get one more point of priority, 0 for no aging
+     */
+    void SLURMJobQueue::setAgeInterval(double ageInterval) {
+        assert(this->queue.empty());
+        this->queue = SLURMQueue(slurm_priority_t(ageInterval));
+        this->currentIterator = this->queue.end();
+    }
+
+    /**
+     * Returns the priority that a job has at a given time
+     * @param job The job
+     * @param time The time
+     * @return The priority of the job at time
+     */
+    double SLURMJobQueue::getPriority(Job* job, double time) {
+        return this->queue.key_comp().priority(job, time);
+    }
     
-    void SLURMJobQueue::dump(){
+    void SLURMJobQueue::dump(double time){
         for (SLURMQueue::iterator it = queue.begin(); it != queue.end(); ++it){
-             log->debug("Job " + to_string((*it)->getJobNumber()) + " has priority " + to_string((*it)->getslurmprio()), 2);
+             LOG_DEBUG(log, "Job " + to_string((*it)->getJobNumber()) + " has priority " + to_string(this->getPriority(*it, time)), 2);
         }
     }
 
@@ -42,14 +42,45 @@ namespace Utils {
      * Else return false
      * If equal priority, if job1 has lower jobid, return true
      * Else return false
+     *
+     * The priority of a job is its base priority plus its multifactor priority plus one point of age for every
+     * ageInterval seconds since it became eligible. All the jobs age at the same rate, so the order does not change with the time and the priority at
+     * a given time is only evaluated when it is asked for, the jobs are never touched to age them.
      * */
     struct slurm_priority_t {
 
+        double ageInterval; /**< The seconds that a job has to wait to get one more point of priority, 0 for no aging */
+
+        slurm_priority_t(double ageInterval = 0) : ageInterval(ageInterval) {
+        }
+
+        /*
+         * Returns the priority of a job at a given time
+         * @param job The job
+         * @param time The time
+         * @return The priority of the job at time
+         */
+        double priority(Job* job, double time) const {
+            return job->getslurmprio() + job->getslurmFactors() + this->age(job, time);
+        }
+
+        /*
+         * Returns the age priority of a job at a given time
+         * @param job The job
+         * @param time The time
+         * @return The age priority of the job at time
+         */
+        double age(Job* job, double time) const {
+            if (this->ageInterval <= 0)
+                return 0;
+            return (time - job->getslurmEligibleTime()) / this->ageInterval;
+        }
+
         bool operator()(Job* job1, Job* job2) const {
 
-            uint32_t p1 = job1->getslurmprio();
-            uint32_t p2 = job1->getslurmprio();
-            assert(p1 >= 0 && p2 >= 0);
+            // The priorities at time 0 keep the order of the priorities at any time
+            double p1 = this->priority(job1, 0);
+            double p2 = this->priority(job2, 0);
             
             if (p1 != p2){
                 return p1 > p2;    
@@ -80,7 +111,10 @@ namespace Utils {
         virtual bool contains(Job* job);
         virtual size_t size();
         virtual void clear();
-        void dump();
+        void dump(double time);
+
+        void setAgeInterval(double ageInterval);
+        double getPriority(Job* job, double time);
 
         SLURMQueue* getQueue();
 
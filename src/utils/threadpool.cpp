@@ -0,0 +1,112 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <utils/threadpool.h>
+
+#include <assert.h>
+
+namespace Utils {
+
+    /**
+     * The constructor for the class
+     * @param numberOfThreads The number of threads that run the tasks, including the one that calls run, 0 is taken as 1
+     */
+    ThreadPool::ThreadPool(uint32_t numberOfThreads) {
+        this->numberOfThreads = (numberOfThreads == 0) ? 1 : numberOfThreads;
+        this->tasks = NULL;
+        this->nextTask = 0;
+        this->pendingTasks = 0;
+        this->stopping = false;
+        for (uint32_t i = 1; i < this->numberOfThreads; i++)
+            this->workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+
+    /**
+     * The destructor for the class, it waits for the workers to finish
+     */
+    ThreadPool::~ThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->taskReady.notify_all();
+        for (uint32_t i = 0; i < this->workers.size(); i++)
+            this->workers[i].join();
+    }
+
+    /**
+     * Runs a batch of tasks and returns when all of them have finished
+     * @param tasks The tasks to run, they must be independent of each other
+     */
+    void ThreadPool::run(const vector<ThreadPoolTask*>& tasks) {
+        if (this->workers.empty() || tasks.size() < 2) {
+            for (uint32_t i = 0; i < tasks.size(); i++)
+                tasks[i]->run();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        assert(this->tasks == NULL);
+        this->tasks = &tasks;
+        this->nextTask = 0;
+        this->pendingTasks = tasks.size();
+        this->taskReady.notify_all();
+
+        while (this->nextTask < tasks.size()) {
+            ThreadPoolTask* task = tasks[this->nextTask++];
+            lock.unlock();
+            task->run();
+            lock.lock();
+            this->pendingTasks--;
+        }
+        while (this->pendingTasks > 0)
+            this->batchDone.wait(lock);
+        this->tasks = NULL;
+    }
+
+    /**
+     * Returns the number of threads that run the tasks
+     * @return The number of threads, including the caller
+     */
+    uint32_t ThreadPool::getNumberOfThreads() const {
+        return this->numberOfThreads;
+    }
+
+    /**
+     * The loop of the workers, they take the tasks of the current batch until there are no more and then wait for the next one
+     */
+    void ThreadPool::workerLoop() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        while (true) {
+            while (!this->stopping && (this->tasks == NULL || this->nextTask >= this->tasks->size()))
+                this->taskReady.wait(lock);
+            if (this->stopping)
+                return;
+
+            ThreadPoolTask* task = (*this->tasks)[this->nextTask++];
+            lock.unlock();
+            task->run();
+            lock.lock();
+            if (--this->pendingTasks == 0)
+                this->batchDone.notify_one();
+        }
+    }
+
+}
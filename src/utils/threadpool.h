@@ -0,0 +1,79 @@
+/*
+* Copyright 2007 Francesc Guim Bernat & Barcelona Supercomputing Centre (fguim@pcmas.ac.upc.edu)
+* Copyright 2019 Daniel Rivas & Barcelona Supercomputing Centre (daniel.rivas@bsc.es)
+* Copyright 2015-2019 NEXTGenIO Project [EC H2020 Project ID: 671951] (www.nextgenio.eu)
+*
+* This file is part of NEXTGenSim.
+*
+* NEXTGenSim is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* NEXTGenSim is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with NEXTGenSim.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATORTHREADPOOL_H
+#define SIMULATORTHREADPOOL_H
+
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+namespace Utils {
+
+    /**
+     * A piece of work run by the thread pool. The tasks of a batch must not share any state that is modified while
+     * they run, the results are left in the task and read once the batch has finished.
+     */
+    class ThreadPoolTask {
+    public:
+        virtual ~ThreadPoolTask() {
+        }
+
+        /**
+         * Does the work of the task
+         */
+        virtual void run() = 0;
+    };
+
+    /**
+     * A fixed set of worker threads that run batches of independent tasks. The thread that runs a batch also runs tasks
+     * of it and waits until all of them have finished, so the caller can consume the results in the order of the tasks and
+     * the outcome does not depend on how the tasks were spread among the threads.
+     * With one thread no worker is started and the tasks are run in order by the caller.
+     */
+    class ThreadPool {
+    public:
+        ThreadPool(uint32_t numberOfThreads);
+        ~ThreadPool();
+
+        void run(const vector<ThreadPoolTask*>& tasks);
+        uint32_t getNumberOfThreads() const;
+
+    private:
+        void workerLoop();
+
+        uint32_t numberOfThreads; /**< The number of threads that run the tasks, the caller included */
+        vector<std::thread> workers; /**< The worker threads */
+        std::mutex mutex; /**< Protects the batch that is being run */
+        std::condition_variable taskReady; /**< Signals the workers that there is a new batch or that they have to finish */
+        std::condition_variable batchDone; /**< Signals the caller that the last task of the batch has finished */
+        const vector<ThreadPoolTask*>* tasks; /**< The batch that is being run, NULL if there is none */
+        size_t nextTask; /**< The first task of the batch that has not been taken by any thread */
+        size_t pendingTasks; /**< The tasks of the batch that have not finished */
+        bool stopping; /**< Asks the workers to finish */
+    };
+
+}
+
+#endif